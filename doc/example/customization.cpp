@@ -190,3 +190,12 @@ struct custom_policy
 #define MOCK_THREAD_SAFE
 #include <turtle/mock.hpp>
 //]
+
+#undef MOCK_MUTEX_POLICY
+#undef MOCK_MUTEX_POLICY_TAG
+//[ mutex_policy
+#define MOCK_THREAD_SAFE
+#define MOCK_MUTEX_POLICY mock::spin_mutex
+#define MOCK_MUTEX_POLICY_TAG spin_mutex
+#include <turtle/mock.hpp>
+//]
@@ -872,6 +872,67 @@ BOOST_AUTO_TEST_CASE(demonstrates_resetting_a_static_mock_method)
 //]
 } // namespace reset_example_4
 
+namespace index_example_1 {
+//[ index_example_1
+MOCK_CLASS(mock_class)
+{
+    MOCK_METHOD(method, 2, int(int, const std::string&))
+};
+
+BOOST_AUTO_TEST_CASE(demonstrates_indexing_a_mock_method)
+{
+    mock_class c;
+    MOCK_INDEX(c.method); // selects the expectations of 'c.method' by the value expected for the first parameter
+    for(int key = 0; key < 1000; ++key)
+        MOCK_EXPECT(c.method).with(key, mock::any).returns(key);
+    MOCK_EXPECT(c.method).with(mock::less(0), "negative").returns(-1); // not indexed but still checked in order
+    BOOST_CHECK_EQUAL(-1, c.method(-3, "negative"));
+    BOOST_CHECK_EQUAL(999, c.method(999, "last"));
+}
+//]
+} // namespace index_example_1
+
+namespace freeze_example_1 {
+//[ freeze_example_1
+MOCK_CLASS(mock_class)
+{
+    MOCK_METHOD(method, 1, int(int))
+};
+
+BOOST_AUTO_TEST_CASE(demonstrates_freezing_a_mock_method)
+{
+    mock_class c;
+    for(int key = 0; key < 1000; ++key)
+        MOCK_EXPECT(c.method).with(key).returns(key);
+    MOCK_FREEZE(c.method); // or mock::freeze( c ) to freeze all the methods of 'c'
+    for(int i = 0; i < 100000; ++i)
+        BOOST_CHECK_EQUAL(i % 1000, c.method(i % 1000));
+    MOCK_EXPECT(c.method).with(-1).returns(0); // unfreezes 'c.method'
+}
+//]
+} // namespace freeze_example_1
+
+namespace static_expectations_example_1 {
+//[ static_expectations_example_1
+template<typename Sensor>
+int count_warnings(Sensor& sensor, int samples)
+{
+    int warnings = 0;
+    for(int i = 0; i < samples; ++i)
+        warnings += sensor(i) > 100;
+    return warnings;
+}
+
+BOOST_AUTO_TEST_CASE(demonstrates_static_expectations)
+{
+    auto sensor =
+      mock::static_expectations<int(int)>(mock::static_expect(42).once().returns(150), // checked first
+                                          mock::static_expect(mock::less(1000)).returns(20));
+    BOOST_CHECK_EQUAL(1, count_warnings(sensor, 1000));
+}
+//]
+} // namespace static_expectations_example_1
+
 namespace helpers_example_1 {
 //[ helpers_example_1
 MOCK_CONSTRAINT(any, true)               // this is how mock::any could be defined
@@ -914,3 +975,29 @@ BOOST_AUTO_TEST_CASE(mock_constraint_2_arity)
 }
 //]
 } // namespace helpers_example_3
+
+namespace helpers_example_4 {
+MOCK_CONSTRAINT(near, expected, std::abs(actual - expected) < 0.01)
+} // namespace helpers_example_4
+
+//[ helpers_example_4
+namespace mock {
+// helpers_example_4::near only performs a subtraction and a comparison
+template<typename Expected>
+struct constraint_cost<helpers_example_4::detail::near<Expected>> :
+    std::integral_constant<evaluation_cost, evaluation_cost::trivial>
+{};
+// and can be evaluated by several threads at once
+template<typename Expected>
+struct stateless_constraint<helpers_example_4::detail::near<Expected>> : std::true_type
+{};
+} // namespace mock
+//]
+
+namespace helpers_example_4 {
+BOOST_AUTO_TEST_CASE(mock_constraint_cost)
+{
+    MOCK_FUNCTOR(f, void(int, int));
+    MOCK_EXPECT(f).with([](int i) { return i % 2 == 0; }, near(42)); // near( 42 ) is evaluated first
+}
+} // namespace helpers_example_4
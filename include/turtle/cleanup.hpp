@@ -10,17 +10,52 @@
 #define MOCK_CLEANUP_HPP_INCLUDED
 
 #include "config.hpp"
+#include "detail/mutex.hpp"
 #include "reset.hpp"
 #include "verify.hpp"
 #ifdef MOCK_USE_BOOST_TEST
+#    include <boost/test/framework.hpp>
+#    include <boost/test/tree/observer.hpp>
 #    include <boost/test/unit_test_suite.hpp>
 #endif
 
 namespace mock {
+#if defined(MOCK_USE_BOOST_TEST) && defined(MOCK_THREAD_SAFE)
+namespace detail {
+    /// Reports the calls buffered by other threads at the end of each test case
+    struct flush_calls_observer : boost::unit_test::test_observer
+    {
+        void test_unit_finish(const boost::unit_test::test_unit& tu, unsigned long) override
+        {
+            if(tu.p_type == boost::unit_test::TUT_CASE)
+                flush_calls();
+        }
+
+        /// Registers the observer once for all the translation units
+        /// It is never deregistered as global fixtures may only be destroyed after the framework.
+        static void install()
+        {
+            static flush_calls_observer* const observer = []() {
+                flush_calls_observer* o = new flush_calls_observer;
+                boost::unit_test::framework::register_observer(*o);
+                return o;
+            }();
+            (void)observer;
+        }
+    };
+} // namespace detail
+
 struct cleanup
 {
+    cleanup() { detail::flush_calls_observer::install(); }
     ~cleanup() { mock::reset(); }
 };
+#else
+struct cleanup
+{
+    ~cleanup() { mock::reset(); }
+};
+#endif
 
 #ifdef MOCK_USE_BOOST_TEST
 BOOST_GLOBAL_FIXTURE(cleanup)
@@ -24,10 +24,58 @@
 #    endif
 #endif
 
+// The mutex policy changes the layout of the internals of the library, it must be the same in every translation unit
+#ifndef MOCK_MUTEX_POLICY
+#    ifdef MOCK_THREAD_SAFE
+#        ifdef MOCK_HDR_MUTEX
+#            define MOCK_MUTEX_POLICY std::recursive_mutex
+#            define MOCK_MUTEX_POLICY_TAG std_recursive_mutex
+#        else
+#            define MOCK_MUTEX_POLICY boost::recursive_mutex
+#            define MOCK_MUTEX_POLICY_TAG boost_recursive_mutex
+#        endif
+#    else
+#        define MOCK_MUTEX_POLICY mock::null_mutex
+#        define MOCK_MUTEX_POLICY_TAG null_mutex
+#    endif
+#endif
+#ifndef MOCK_MUTEX_POLICY_TAG
+#    define MOCK_MUTEX_POLICY_TAG custom_mutex
+#endif
+
+#ifndef MOCK_CALLABLE_BUFFER_SIZE
+#    define MOCK_CALLABLE_BUFFER_SIZE (4 * sizeof(void*))
+#endif
+
+#if !defined(BOOST_NO_CXX14_HDR_SHARED_MUTEX)
+#    ifndef MOCK_NO_HDR_SHARED_MUTEX
+#        define MOCK_HDR_SHARED_MUTEX
+#    endif
+#endif
+
 #if defined(__cpp_lib_uncaught_exceptions) || defined(_MSC_VER) && (_MSC_VER >= 1900)
 #    ifndef MOCK_NO_UNCAUGHT_EXCEPTIONS
 #        define MOCK_UNCAUGHT_EXCEPTIONS
 #    endif
 #endif
 
+#ifndef MOCK_NO_SIMD
+#    if defined(__AVX__)
+#        define MOCK_AVX
+#    elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define MOCK_SSE2
+#    endif
+#endif
+
+// Internals built with different mutex policies or thread safety modes are told apart by an inline namespace,
+// which every later definition of mock::detail extends, so that mixing them up fails to link instead of silently
+// violating the one definition rule
+#ifdef MOCK_THREAD_SAFE
+#    define MOCK_MUTEX_NAMESPACE BOOST_JOIN(thread_safe_, MOCK_MUTEX_POLICY_TAG)
+#else
+#    define MOCK_MUTEX_NAMESPACE BOOST_JOIN(thread_unsafe_, MOCK_MUTEX_POLICY_TAG)
+#endif
+namespace mock { inline namespace MOCK_MUTEX_NAMESPACE { namespace detail {
+}}} // namespace mock::MOCK_MUTEX_NAMESPACE::detail
+
 #endif // MOCK_CONFIG_HPP_INCLUDED
@@ -31,6 +31,31 @@ struct constraint
     Constraint c_;
 };
 
+/// Relative cost of evaluating a constraint
+enum class evaluation_cost
+{
+    trivial,    ///< e.g. a single comparison
+    cheap,      ///< e.g. a floating point tolerance or a sub-string search
+    expensive,  ///< unknown, e.g. a user supplied functor
+    side_effect ///< modifies its argument or the outside world
+};
+
+/// Hint on the cost of evaluating a constraint
+/// The constraints set for the parameters of an expectation are evaluated from the cheapest to the most
+/// expensive and the evaluation stops at the first one which fails.
+/// Specialize for a custom constraint to change its default cost.
+template<typename Constraint>
+struct constraint_cost : std::integral_constant<evaluation_cost, evaluation_cost::expensive>
+{};
+
+/// Whether a constraint can be evaluated by several calls at once in thread safe mode
+/// Only the builtin constraints which neither modify their argument nor any state are known to be stateless,
+/// any other constraint is evaluated by one call at a time.
+/// Specialize as std::true_type for a custom constraint to evaluate it concurrently.
+template<typename Constraint>
+struct stateless_constraint : std::false_type
+{};
+
 namespace detail {
     template<typename Lhs, typename Rhs>
     class and_
@@ -42,6 +67,8 @@ namespace detail {
         {
             return lhs_(actual) && rhs_(actual);
         }
+        const Lhs& lhs() const { return lhs_; }
+        const Rhs& rhs() const { return rhs_; }
         friend std::ostream& operator<<(std::ostream& s, const and_& a)
         {
             return s << "( " << mock::format(a.lhs_) << " && " << mock::format(a.rhs_) << " )";
@@ -89,6 +116,49 @@ namespace detail {
     };
 } // namespace detail
 
+namespace detail {
+    template<typename Lhs, typename Rhs>
+    struct max_cost :
+        std::conditional_t<(constraint_cost<Lhs>::value < constraint_cost<Rhs>::value),
+                           constraint_cost<Rhs>,
+                           constraint_cost<Lhs>>
+    {};
+
+    /// How the result of a constraint evolves when its argument goes through the values of Actual in increasing order
+    enum class monotony
+    {
+        none,       ///< unknown
+        increasing, ///< false then true, e.g. greater
+        decreasing, ///< true then false, e.g. less
+        unimodal    ///< false then true then false around the expected value, e.g. near
+    };
+
+    template<typename Actual, typename Constraint>
+    struct constraint_monotony : std::integral_constant<monotony, monotony::none>
+    {};
+} // namespace detail
+
+template<typename Lhs, typename Rhs>
+struct constraint_cost<detail::and_<Lhs, Rhs>> : detail::max_cost<Lhs, Rhs>
+{};
+template<typename Lhs, typename Rhs>
+struct constraint_cost<detail::or_<Lhs, Rhs>> : detail::max_cost<Lhs, Rhs>
+{};
+template<typename Constraint>
+struct constraint_cost<detail::not_<Constraint>> : constraint_cost<Constraint>
+{};
+template<typename Lhs, typename Rhs>
+struct stateless_constraint<detail::and_<Lhs, Rhs>> :
+    std::integral_constant<bool, stateless_constraint<Lhs>::value && stateless_constraint<Rhs>::value>
+{};
+template<typename Lhs, typename Rhs>
+struct stateless_constraint<detail::or_<Lhs, Rhs>> :
+    std::integral_constant<bool, stateless_constraint<Lhs>::value && stateless_constraint<Rhs>::value>
+{};
+template<typename Constraint>
+struct stateless_constraint<detail::not_<Constraint>> : stateless_constraint<Constraint>
+{};
+
 template<typename Lhs, typename Rhs>
 const constraint<detail::or_<Lhs, Rhs>> operator||(const constraint<Lhs>& lhs, const constraint<Rhs>& rhs)
 {
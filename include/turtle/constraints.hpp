@@ -24,6 +24,11 @@
 #include <type_traits>
 
 namespace mock {
+namespace detail {
+    template<evaluation_cost Cost>
+    using cost_constant = std::integral_constant<evaluation_cost, Cost>;
+} // namespace detail
+
 MOCK_UNARY_CONSTRAINT(any, 0, , ((void)actual, true))
 MOCK_UNARY_CONSTRAINT(affirm, 0, , !!actual)
 MOCK_UNARY_CONSTRAINT(negate, 0, , !actual)
@@ -71,6 +76,12 @@ namespace detail {
 #    define MOCK_SMALL_DEFINED
 #endif
 MOCK_NARY_CONSTRAINT(small, 1, (tolerance), (MOCK_SMALL()))
+template<typename Tolerance>
+struct constraint_cost<detail::small<Tolerance>> : detail::cost_constant<evaluation_cost::cheap>
+{};
+template<typename Tolerance>
+struct stateless_constraint<detail::small<Tolerance>> : std::true_type
+{};
 #ifdef MOCK_SMALL_DEFINED
 #    pragma pop_macro("small")
 #endif
@@ -88,6 +99,23 @@ MOCK_NARY_CONSTRAINT(close_fraction, 2, (expected, tolerance), (MOCK_FRACTION_TO
 #    define MOCK_NEAR_DEFINED
 #endif
 MOCK_NARY_CONSTRAINT(near, 2, (expected, tolerance), std::abs(actual - expected) <= tolerance)
+template<typename Expected, typename Tolerance>
+struct constraint_cost<detail::near<Expected, Tolerance>> : detail::cost_constant<evaluation_cost::cheap>
+{};
+template<typename Expected, typename Tolerance>
+struct stateless_constraint<detail::near<Expected, Tolerance>> : std::true_type
+{};
+namespace detail {
+    // integral subtractions may overflow when going through all the values of Actual
+    template<typename Actual, typename Expected, typename Tolerance>
+    struct constraint_monotony<Actual, near<Expected, Tolerance>> :
+        std::integral_constant<monotony,
+                               std::is_floating_point<Actual>::value && std::is_arithmetic<Expected>::value &&
+                                   std::is_arithmetic<Tolerance>::value ?
+                                 monotony::unimodal :
+                                 monotony::none>
+    {};
+} // namespace detail
 #ifdef MOCK_NEAR_DEFINED
 #    pragma pop_macro("near")
 #endif
@@ -216,6 +244,123 @@ namespace detail {
     };
 } // namespace detail
 
+template<>
+struct constraint_cost<detail::any> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<>
+struct constraint_cost<detail::affirm> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<>
+struct constraint_cost<detail::negate> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<typename Expected>
+struct constraint_cost<detail::equal<Expected>> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<typename Expected>
+struct constraint_cost<detail::same<Expected>> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<typename Expected>
+struct constraint_cost<detail::less<Expected>> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<typename Expected>
+struct constraint_cost<detail::greater<Expected>> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<typename Expected>
+struct constraint_cost<detail::less_equal<Expected>> : detail::cost_constant<evaluation_cost::trivial>
+{};
+template<typename Expected>
+struct constraint_cost<detail::greater_equal<Expected>> : detail::cost_constant<evaluation_cost::trivial>
+{};
+
+template<>
+struct stateless_constraint<detail::any> : std::true_type
+{};
+template<>
+struct stateless_constraint<detail::affirm> : std::true_type
+{};
+template<>
+struct stateless_constraint<detail::negate> : std::true_type
+{};
+template<typename Expected>
+struct stateless_constraint<detail::equal<Expected>> : std::true_type
+{};
+template<typename Expected>
+struct stateless_constraint<detail::same<Expected>> : std::true_type
+{};
+template<typename Expected>
+struct stateless_constraint<detail::less<Expected>> : std::true_type
+{};
+template<typename Expected>
+struct stateless_constraint<detail::greater<Expected>> : std::true_type
+{};
+template<typename Expected>
+struct stateless_constraint<detail::less_equal<Expected>> : std::true_type
+{};
+template<typename Expected>
+struct stateless_constraint<detail::greater_equal<Expected>> : std::true_type
+{};
+
+namespace detail {
+    /// Trait to return true if comparing Actual to Expected preserves the order of the values of Actual,
+    /// which is not the case when a signed value gets converted to unsigned
+    template<typename Actual, typename Expected, typename Enable = void>
+    struct is_ordered_comparison : std::false_type
+    {};
+    template<typename Actual, typename Expected>
+    struct is_ordered_comparison<
+      Actual,
+      Expected,
+      std::enable_if_t<std::is_arithmetic<Actual>::value && std::is_arithmetic<Expected>::value>> :
+        std::integral_constant<bool,
+                               !std::is_signed<Actual>::value ||
+                                 !std::is_unsigned<std::common_type_t<Actual, Expected>>::value>
+    {};
+
+    template<typename Actual, typename Expected, monotony M>
+    using comparison_monotony =
+      std::integral_constant<monotony, is_ordered_comparison<Actual, Expected>::value ? M : monotony::none>;
+
+    template<typename Actual, typename Expected>
+    struct constraint_monotony<Actual, less<Expected>> : comparison_monotony<Actual, Expected, monotony::decreasing>
+    {};
+    template<typename Actual, typename Expected>
+    struct constraint_monotony<Actual, less_equal<Expected>> :
+        comparison_monotony<Actual, Expected, monotony::decreasing>
+    {};
+    template<typename Actual, typename Expected>
+    struct constraint_monotony<Actual, greater<Expected>> :
+        comparison_monotony<Actual, Expected, monotony::increasing>
+    {};
+    template<typename Actual, typename Expected>
+    struct constraint_monotony<Actual, greater_equal<Expected>> :
+        comparison_monotony<Actual, Expected, monotony::increasing>
+    {};
+} // namespace detail
+template<typename Expected, typename Tolerance>
+struct constraint_cost<detail::close<Expected, Tolerance>> : detail::cost_constant<evaluation_cost::cheap>
+{};
+template<typename Expected, typename Tolerance>
+struct constraint_cost<detail::close_fraction<Expected, Tolerance>> : detail::cost_constant<evaluation_cost::cheap>
+{};
+template<typename Expected>
+struct constraint_cost<detail::contain<Expected>> : detail::cost_constant<evaluation_cost::cheap>
+{};
+template<typename Expected, typename Tolerance>
+struct stateless_constraint<detail::close<Expected, Tolerance>> : std::true_type
+{};
+template<typename Expected, typename Tolerance>
+struct stateless_constraint<detail::close_fraction<Expected, Tolerance>> : std::true_type
+{};
+template<typename Expected>
+struct stateless_constraint<detail::contain<Expected>> : std::true_type
+{};
+template<typename Expected>
+struct constraint_cost<detail::retrieve<Expected>> : detail::cost_constant<evaluation_cost::side_effect>
+{};
+template<typename Expected>
+struct constraint_cost<detail::assign<Expected>> : detail::cost_constant<evaluation_cost::side_effect>
+{};
+
 template<typename T>
 constraint<detail::equal<T>> equal(T&& t)
 {
@@ -10,8 +10,11 @@
 #define MOCK_ACTION_HPP_INCLUDED
 
 #include "../config.hpp"
+#include "arena.hpp"
+#include "callable.hpp"
 #include <functional>
-#include <memory>
+#include <new>
+#include <stdexcept>
 #include <type_traits>
 
 namespace mock { namespace detail {
@@ -19,8 +22,8 @@ namespace mock { namespace detail {
     class action_base
     {
     private:
-        typedef std::function<Signature> functor_type;
-        typedef std::function<Result()> action_type;
+        typedef callable<Signature> functor_type;
+        typedef callable<Result()> action_type;
 
     protected:
         // Meant to be subclassed and not be directly used
@@ -34,27 +37,34 @@ namespace mock { namespace detail {
     public:
         const functor_type& functor() const { return f_; }
         bool valid() const { return f_ || a_; }
+        /// Whether trigger() only copies a value stored in the action itself
+        bool is_inline() const { return false; }
         Result trigger() const { return a_(); }
 
-        void calls(const functor_type& f)
+        template<typename F>
+        void calls(F&& f)
         {
-            if(!f)
+            if(is_null(f))
                 throw std::invalid_argument("null functor");
-            f_ = f;
+            f_.emplace(std::forward<F>(f));
         }
 
         template<typename Exception>
         void throws(Exception e)
         {
-            a_ = [e]() -> Result { throw e; };
+            a_.emplace([e]() -> Result { throw e; });
         }
 
     protected:
-        void set(const action_type& a) { a_ = a; }
+        template<typename F>
+        void set(F&& f)
+        {
+            a_.emplace(std::forward<F>(f));
+        }
         template<typename Y>
-        void set(const std::reference_wrapper<Y>& r)
+        void set_reference(const std::reference_wrapper<Y>& r)
         {
-            a_ = [r]() -> Result { return r.get(); };
+            a_.emplace([r]() -> Result { return r.get(); });
         }
 
     private:
@@ -83,19 +93,37 @@ namespace mock { namespace detail {
         type t_;
     };
 
-    template<typename Result, typename Signature>
+    /// Address unique to the type `T`, telling apart the values stored without relying on RTTI
+    template<typename T>
+    struct value_tag
+    {
+        static const char id;
+    };
+    template<typename T>
+    const char value_tag<T>::id = 0;
+
+    /// Whether results of type `Result` can be copied out of the action on every call.
+    /// Restricted to scalars as class types may still be incomplete when the action is declared.
+    template<typename Result>
+    using is_inline_result = std::is_scalar<Result>;
+
+    /// Values returned are stored in `a`, which must outlive the action
+    template<typename Result, typename Signature, bool Inline = is_inline_result<Result>::value>
     class action : public action_base<Result, Signature>
     {
     public:
+        explicit action(arena& a) : arena_(&a), v_(nullptr), type_(nullptr) {}
+        ~action() { destroy(); }
+
         template<typename Value>
         void returns(const Value& v)
         {
-            this->set(std::ref(store(v)));
+            this->set_reference(std::ref(store(v)));
         }
         template<typename Y>
         void returns(const std::reference_wrapper<Y>& r)
         {
-            this->set(r);
+            this->set_reference(r);
         }
 
         template<typename Value>
@@ -109,27 +137,139 @@ namespace mock { namespace detail {
         template<typename T>
         typename value_imp<T>::type& store(T&& t)
         {
-            v_ = std::make_unique<value_imp<T>>(std::forward<T>(t));
-            return static_cast<value_imp<T>&>(*v_).t_;
+            return emplace<value_imp<typename value_imp<T>::type>>(std::forward<T>(t));
         }
         template<typename T>
         std::remove_reference_t<Result>& store(T* t)
         {
-            v_ = std::make_unique<value_imp<Result>>(t);
-            return static_cast<value_imp<Result>&>(*v_).t_;
+            return emplace<value_imp<typename value_imp<Result>::type>>(t);
+        }
+        /// The arena only releases memory upon reset, so a value replacing one of the same type takes its place
+        template<typename Value, typename T>
+        typename Value::type& emplace(T&& t)
+        {
+            Value* v = type_ == &value_tag<Value>::id ? static_cast<Value*>(v_) : nullptr;
+            destroy();
+            v = v ? new(v) Value(std::forward<T>(t)) : arena_->create<Value>(std::forward<T>(t));
+            v_ = v;
+            type_ = &value_tag<Value>::id;
+            return v->t_;
+        }
+        void destroy()
+        {
+            if(v_)
+                v_->~value();
+            v_ = nullptr;
+            type_ = nullptr;
+        }
+
+        arena* arena_;
+        value* v_;
+        /// Tag of the type of `v_`
+        const char* type_;
+    };
+
+    /// Values convertible to a scalar `Result` are stored inline and returned directly,
+    /// anything else goes through the type erased action
+    template<typename Result, typename Signature>
+    class action<Result, Signature, true> : public action<Result, Signature, false>
+    {
+        typedef action<Result, Signature, false> base_type;
+
+    public:
+        explicit action(arena& a) : base_type(a), inline_(false) {}
+
+        bool valid() const { return inline_ || base_type::valid(); }
+        bool is_inline() const { return inline_; }
+        Result trigger() const { return inline_ ? storage_.value : base_type::trigger(); }
+
+        template<typename Value>
+        void returns(const Value& v)
+        {
+            returns(v, std::is_convertible<const Value&, Result>());
+        }
+        template<typename Y>
+        void returns(const std::reference_wrapper<Y>& r)
+        {
+            inline_ = false;
+            base_type::returns(r);
+        }
+
+        template<typename Value>
+        void moves(Value&& v)
+        {
+            moves(std::move(v), std::is_convertible<Value, Result>());
+        }
+
+        template<typename Exception>
+        void throws(Exception e)
+        {
+            inline_ = false;
+            base_type::throws(e);
+        }
+
+    private:
+        template<typename Value>
+        void returns(const Value& v, std::true_type)
+        {
+            store(v);
+        }
+        template<typename Value>
+        void returns(const Value& v, std::false_type)
+        {
+            inline_ = false;
+            base_type::returns(v);
+        }
+        template<typename Value>
+        void moves(Value&& v, std::true_type)
+        {
+            store(std::move(v));
         }
+        template<typename Value>
+        void moves(Value&& v, std::false_type)
+        {
+            inline_ = false;
+            base_type::moves(std::move(v));
+        }
+        template<typename Value>
+        void store(Value&& v)
+        {
+            new(&storage_.value) type(std::forward<Value>(v));
+            inline_ = true;
+        }
+
+        typedef std::remove_const_t<Result> type;
+        union storage
+        {
+            storage() : none() {}
+            char none;
+            type value;
+        };
 
-        std::unique_ptr<value> v_;
+        storage storage_;
+        bool inline_;
     };
 
     template<typename Signature>
-    class action<void, Signature> : public action_base<void, Signature>
+    class action<void, Signature, false> : public action_base<void, Signature>
     {
     public:
-        action()
+        explicit action(arena&) : inline_(true)
         {
             this->set([]() {});
         }
+
+        bool is_inline() const { return inline_; }
+
+        template<typename Exception>
+        void throws(Exception e)
+        {
+            inline_ = false;
+            action_base<void, Signature>::throws(e);
+        }
+
+    private:
+        bool inline_;
     };
 
 }} // namespace mock::detail
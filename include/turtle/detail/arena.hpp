@@ -0,0 +1,116 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_ARENA_HPP_INCLUDED
+#define MOCK_ARENA_HPP_INCLUDED
+
+#include "../config.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace mock { namespace detail {
+    /// Bump allocator handing out memory from chunks of doubling size, all released at once.
+    /// Objects created in it must be destroyed by their owner before the arena is cleared,
+    /// the memory of a single object is never reused.
+    class arena
+    {
+    public:
+        arena() : chunks_(nullptr), current_(nullptr), end_(nullptr) {}
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+        ~arena()
+        {
+            while(chunks_)
+                chunks_ = release(chunks_);
+        }
+
+        void* allocate(std::size_t size, std::size_t alignment)
+        {
+            char* p = align(current_, alignment);
+            if(!p || p > end_ || size > static_cast<std::size_t>(end_ - p))
+                p = grow(size, alignment);
+            current_ = p + size;
+            return p;
+        }
+
+        /// Constructs a `T` from `ts` in the arena
+        template<typename T, typename... Ts>
+        T* create(Ts&&... ts)
+        {
+            return new(allocate(sizeof(T), alignof(T))) T(std::forward<Ts>(ts)...);
+        }
+
+        /// Releases all allocations but keeps the storage of the largest chunk
+        void clear()
+        {
+            if(!chunks_)
+                return;
+            chunk* next = chunks_->next;
+            while(next)
+                next = release(next);
+            chunks_->next = nullptr;
+            current_ = data(chunks_);
+            end_ = current_ + chunks_->size;
+        }
+
+        /// Number of chunks allocated
+        std::size_t chunks() const
+        {
+            std::size_t n = 0;
+            for(const chunk* c = chunks_; c; c = c->next)
+                ++n;
+            return n;
+        }
+
+    private:
+        struct chunk
+        {
+            chunk* next;
+            std::size_t size;
+        };
+        static constexpr std::size_t header = (sizeof(chunk) + alignof(std::max_align_t) - 1) /
+                                              alignof(std::max_align_t) * alignof(std::max_align_t);
+        static constexpr std::size_t initial_size = 512;
+
+        static char* data(chunk* c) { return reinterpret_cast<char*>(c) + header; }
+        static char* align(char* p, std::size_t alignment)
+        {
+            if(!p)
+                return nullptr;
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p);
+            return p + (alignment - address % alignment) % alignment;
+        }
+        static chunk* release(chunk* c)
+        {
+            chunk* next = c->next;
+            c->~chunk();
+            ::operator delete(c);
+            return next;
+        }
+
+        char* grow(std::size_t size, std::size_t alignment)
+        {
+            const std::size_t required = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+            const std::size_t capacity = std::max(required, chunks_ ? chunks_->size * 2 : initial_size);
+            chunks_ = new(::operator new(header + capacity)) chunk{ chunks_, capacity };
+            current_ = data(chunks_);
+            end_ = current_ + capacity;
+            return align(current_, alignment);
+        }
+
+        /// Most recent and largest chunk first
+        chunk* chunks_;
+        char* current_;
+        char* end_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_ARENA_HPP_INCLUDED
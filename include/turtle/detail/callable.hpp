@@ -0,0 +1,109 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_CALLABLE_HPP_INCLUDED
+#define MOCK_CALLABLE_HPP_INCLUDED
+
+#include "../config.hpp"
+#include "inline_ptr.hpp"
+#include "ref_arg.hpp"
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace mock { namespace detail {
+    /// Returns true if `f` is a null function pointer or an empty function object
+    template<typename F>
+    bool is_null(const F&)
+    {
+        return false;
+    }
+    template<typename T>
+    bool is_null(T* f)
+    {
+        return !f;
+    }
+    template<typename T, typename C>
+    bool is_null(T C::*f)
+    {
+        return !f;
+    }
+    template<typename Signature>
+    bool is_null(const std::function<Signature>& f)
+    {
+        return !f;
+    }
+
+    template<typename Signature, std::size_t Size = MOCK_CALLABLE_BUFFER_SIZE>
+    class callable;
+
+    /// Type erased callable which is neither copyable nor movable and therefore accepts move-only functors.
+    /// Functors of up to `Size` bytes are stored inline, larger ones on the heap.
+    template<typename R, typename... Args, std::size_t Size>
+    class callable<R(Args...), Size>
+    {
+        struct base
+        {
+            virtual ~base() = default;
+            virtual R operator()(ref_arg_t<Args>... args) = 0;
+        };
+        template<typename F>
+        struct imp : base
+        {
+            template<typename T>
+            explicit imp(T&& t) : f_(std::forward<T>(t))
+            {}
+            R operator()(ref_arg_t<Args>... args) override
+            {
+                return call(std::is_void<R>(), static_cast<ref_arg_t<Args>>(args)...);
+            }
+            R call(std::false_type, ref_arg_t<Args>... args) { return f_(static_cast<ref_arg_t<Args>>(args)...); }
+            void call(std::true_type, ref_arg_t<Args>... args) { f_(static_cast<ref_arg_t<Args>>(args)...); }
+
+            F f_;
+        };
+
+        template<typename F>
+        static F&& wrap(F&& f)
+        {
+            return std::forward<F>(f);
+        }
+        template<typename T, typename C>
+        static auto wrap(T C::*f)
+        {
+            return std::mem_fn(f);
+        }
+        template<typename F>
+        using target = std::decay_t<decltype(wrap(std::declval<F>()))>;
+
+    public:
+        callable() = default;
+        callable(const callable&) = delete;
+        callable& operator=(const callable&) = delete;
+
+        /// Replaces the current functor with `f`
+        template<typename F>
+        void emplace(F&& f)
+        {
+            f_.template emplace<imp<target<F>>>(wrap(std::forward<F>(f)));
+        }
+        void reset() { f_.reset(); }
+
+        R operator()(ref_arg_t<Args>... args) const { return (*f_)(static_cast<ref_arg_t<Args>>(args)...); }
+        explicit operator bool() const { return static_cast<bool>(f_); }
+
+        /// Returns true if the functor is stored in the internal buffer
+        bool is_inline() const { return f_.is_inline(); }
+
+    private:
+        inline_ptr<base, Size> f_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_CALLABLE_HPP_INCLUDED
@@ -27,7 +27,7 @@ namespace mock { namespace detail {
                     boost::unit_test::const_string name)
         {
             if(instance != "?." || name_.empty())
-                p = parent(instance, type);
+                p = parent(instance, type, name);
             parent_ = &p;
             name_ = name;
         }
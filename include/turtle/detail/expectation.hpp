@@ -12,8 +12,13 @@
 #include "../matcher.hpp"
 #include "../sequence.hpp"
 #include "action.hpp"
+#include "expectation_index.hpp"
+#include "inline_ptr.hpp"
 #include "invocation.hpp"
 #include "matcher_base.hpp"
+#include "matcher_tuple.hpp"
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <tuple>
 #include <type_traits>
@@ -47,35 +52,36 @@ namespace mock { namespace detail {
         static_assert(sizeof...(Constraints) == sizeof...(Args), "Need exactly 1 constraint per argument");
 
     public:
-        single_matcher(Constraints... constraints) : matchers_(matcher<Args, Constraints>(constraints)...) {}
+        single_matcher(Constraints... constraints)
+            : matchers_(constraints...),
+              keyed_(equality_key<first_type<Args...>, first_type<Constraints...>>::hash(
+                std::get<0>(std::tie(constraints...)), key_)),
+              range_(std::get<0>(std::tie(constraints...)))
+        {}
 
     private:
-        template<std::size_t... I>
-        bool is_valid_impl(std::index_sequence<I...>, ref_arg_t<Args>... t)
-        {
-            using expander = bool[];
-            bool result = true;
-            (void)expander{ result &= std::get<I>(matchers_)(static_cast<ref_arg_t<Args>>(t))... };
-            return result;
-        }
-        bool operator()(ref_arg_t<Args>... t) override
-        {
-            return is_valid_impl(std::make_index_sequence<sizeof...(Args)>{}, static_cast<ref_arg_t<Args>>(t)...);
-        }
-        template<std::size_t... I>
-        void serialize_impl(std::index_sequence<I...>, std::ostream& s) const
+        template<typename... Ts>
+        using first_type = std::tuple_element_t<0, std::tuple<Ts...>>;
+
+        bool key(std::size_t& key) const override
         {
-            using expander = int[];
-            s << std::get<0>(matchers_);
-            (void)expander{ 0, (s << ", " << std::get<I + 1>(matchers_), 0)... };
+            key = key_;
+            return keyed_;
         }
-        void serialize(std::ostream& s) const override
+        bool range(double& lower, double& upper) const override { return range_.bounds(lower, upper); }
+        bool is_stateless() const override
         {
-            serialize_impl(std::make_index_sequence<sizeof...(Args) - 1>{}, s);
+            const bool stateless[] = { matcher_stateless<matcher<Args, Constraints>>::value... };
+            return std::find(std::begin(stateless), std::end(stateless), false) == std::end(stateless);
         }
+        bool operator()(ref_arg_t<Args>... t) override { return matchers_(static_cast<ref_arg_t<Args>>(t)...); }
+        void serialize(std::ostream& s) const override { s << matchers_; }
 
     private:
-        std::tuple<matcher<Args, Constraints>...> matchers_;
+        matcher_tuple<void(Constraints...), Args...> matchers_;
+        std::size_t key_ = 0;
+        bool keyed_;
+        range_key<first_type<Args...>, first_type<Constraints...>> range_;
     };
 
     template<typename F, typename... Args>
@@ -87,6 +93,7 @@ namespace mock { namespace detail {
         multi_matcher(const F& f) : f_(f) {}
 
     private:
+        bool is_stateless() const override { return stateless_constraint<F>::value; }
         bool operator()(ref_arg_t<Args>... t) override { return f_(static_cast<ref_arg_t<Args>>(t)...); }
         void serialize(std::ostream& s) const override { s << mock::format(f_); }
 
@@ -98,73 +105,113 @@ namespace mock { namespace detail {
     class expectation;
 
     template<typename R, typename... Args>
-    class expectation<R(Args...)> : public action<R, R(Args...)>
+    class expectation<R(Args...)>
     {
         static constexpr std::size_t arity = sizeof...(Args);
 
     public:
-        expectation() : expectation("unknown location", 0) {}
-        expectation(const char* file, int line)
-            : invocation_(std::make_unique<unlimited>()), matcher_(std::make_unique<default_matcher<Args...>>()),
-              file_(file), line_(line)
-        {}
+        /// Matchers, values too large to be stored inline and the details of the expectation are created in `a`,
+        /// which must outlive the expectation
+        explicit expectation(arena& a) : expectation(a, "unknown location", 0) {}
+        expectation(arena& a, const char* file, int line)
+            : invocation_(unlimited()), any_(true), stateless_(true), sequenced_(false), action_(a),
+              details_(a.create<details>(a, file, line))
+        {
+            matcher_.template emplace<default_matcher<Args...>>();
+        }
 
-        expectation(expectation&&) = default;
-        expectation(expectation const&) = default;
-        expectation& operator=(expectation&&) = default;
-        expectation& operator=(expectation const&) = default;
+        expectation(const expectation&) = delete;
+        expectation& operator=(const expectation&) = delete;
 
         ~expectation()
         {
-            for(auto& sequence : sequences_)
+            for(auto& sequence : details_->sequences_)
                 sequence->remove(this);
+            details_->~details();
         }
 
-        void invoke(std::unique_ptr<invocation> i) { invocation_ = std::move(i); }
+        void invoke(const invocation& i) { invocation_ = i; }
 
         template<typename... Constraints>
         std::enable_if_t<(arity > 0u) && sizeof...(Constraints) == arity> with(Constraints... c)
         {
-            matcher_ = std::make_unique<single_matcher<void(Constraints...), Args...>>(c...);
+            set_matcher<single_matcher<void(Constraints...), Args...>>(c...);
         }
         template<typename Constraint, std::size_t Arity = arity>
         std::enable_if_t<(Arity > 1u)> with(const Constraint& c)
         {
-            matcher_ = std::make_unique<multi_matcher<Constraint, Args...>>(c);
+            set_matcher<multi_matcher<Constraint, Args...>>(c);
         }
 
         void add(sequence& s)
         {
             s.impl_->add(this);
-            sequences_.push_back(s.impl_);
+            details_->sequences_.push_back(s.impl_);
+            sequenced_ = true;
         }
 
-        bool verify() const { return invocation_->verify(); }
+        template<typename F>
+        void calls(F&& f)
+        {
+            action_.calls(std::forward<F>(f));
+        }
+        template<typename Exception>
+        void throws(Exception e)
+        {
+            action_.throws(e);
+        }
+        template<typename Value>
+        void returns(const Value& v)
+        {
+            action_.returns(v);
+        }
+        template<typename Value>
+        void moves(Value&& v)
+        {
+            action_.moves(std::move(v));
+        }
+
+        const auto& functor() const { return action_.functor(); }
+        bool valid() const { return action_.valid(); }
+        bool is_inline() const { return action_.is_inline(); }
+        R trigger() const { return action_.trigger(); }
+
+        bool verify() const { return invocation_.verify(); }
+
+        bool key(std::size_t& k) const { return matcher_->key(k); }
+        bool range(double& lower, double& upper) const { return matcher_->range(lower, upper); }
+
+        bool exhausted() const { return invocation_.exhausted(); }
+
+        /// Returns true if matching the arguments can run concurrently with other calls
+        bool is_stateless() const { return stateless_; }
 
         bool is_valid(ref_arg_t<Args>... t) const
         {
-            return !invocation_->exhausted() && (*matcher_)(static_cast<ref_arg_t<Args>>(t)...);
+            return any_ || (*matcher_)(static_cast<ref_arg_t<Args>>(t)...);
         }
 
         bool invoke() const
         {
-            for(auto& sequence : sequences_)
+            if(!sequenced_)
+                return invocation_.invoke();
+            for(auto& sequence : details_->sequences_)
             {
                 if(!sequence->is_valid(this))
                     return false;
             }
-            bool result = invocation_->invoke();
-            for(auto& sequence : sequences_)
+            bool result = invocation_.invoke();
+            for(auto& sequence : details_->sequences_)
                 sequence->invalidate(this);
             return result;
         }
 
-        const char* file() const { return file_; }
-        int line() const { return line_; }
+        const char* file() const { return details_->file_; }
+        int line() const { return details_->line_; }
 
         friend std::ostream& operator<<(std::ostream& s, const expectation& e)
         {
-            s << (e.invocation_->exhausted() ? 'v' : '.') << ' ' << *e.invocation_;
+            s << (e.invocation_.exhausted() ? 'v' : '.') << ' ' << e.invocation_;
             constexpr bool hasArguments = arity > 0u;
             if(hasArguments)
                 s << ".with( " << *e.matcher_ << " )";
@@ -172,11 +219,46 @@ namespace mock { namespace detail {
         }
 
     private:
-        std::unique_ptr<invocation> invocation_;
-        std::unique_ptr<matcher_base<Args...>> matcher_;
-        std::vector<std::shared_ptr<sequence_impl>> sequences_;
-        const char* file_;
-        int line_;
+        template<typename Matcher, typename... Ts>
+        void set_matcher(const Ts&... ts)
+        {
+            try
+            {
+                matcher_.template emplace_in<Matcher>(details_->arena_, ts...);
+                stateless_ = matcher_->is_stateless();
+                any_ = false;
+            } catch(...)
+            {
+                matcher_.template emplace<default_matcher<Args...>>();
+                any_ = true;
+                stateless_ = true;
+                throw;
+            }
+        }
+
+        /// Only needed to set up the expectation and to report errors
+        struct details
+        {
+            details(arena& a, const char* file, int line) : arena_(a), file_(file), line_(line) {}
+
+            arena& arena_;
+            std::vector<std::shared_ptr<sequence_impl>> sequences_;
+            const char* file_;
+            int line_;
+        };
+
+        // Selecting the expectation for a call only reads the members up to the matcher, they come first
+        // to span as few cache lines as possible.
+        mutable invocation invocation_;
+        /// No constraint has been set, the default matcher accepts any arguments and is only used for serialization
+        bool any_;
+        bool stateless_;
+        /// Part of at least one sequence
+        bool sequenced_;
+        /// Matchers for a few simple constraints are stored inline to avoid allocating
+        inline_ptr<matcher_base<Args...>, 8 * sizeof(void*)> matcher_;
+        action<R, R(Args...)> action_;
+        details* details_;
     };
 }} // namespace mock::detail
 
@@ -0,0 +1,419 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_EXPECTATION_INDEX_HPP_INCLUDED
+#define MOCK_EXPECTATION_INDEX_HPP_INCLUDED
+
+#include "../config.hpp"
+#include "../constraints.hpp"
+#include "is_functor.hpp"
+#include "range_scan.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace mock { namespace detail {
+    template<typename T>
+    struct is_char_pointer : std::false_type
+    {};
+    template<typename T>
+    struct is_char_pointer<T*> : std::is_same<std::remove_cv_t<T>, char>
+    {};
+
+    /// Trait to return true if T can be used as a key of the expectation index
+    /// Restricted to types where equality and hashing are known to be consistent
+    template<typename T>
+    struct is_key :
+        std::integral_constant<bool,
+                               std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+                                 (std::is_pointer<T>::value && !is_char_pointer<T>::value) ||
+                                 std::is_same<T, std::string>::value>
+    {};
+
+    template<typename Key>
+    std::size_t key_hash(const Key& k, std::enable_if_t<!std::is_enum<Key>::value>* = 0)
+    {
+        return std::hash<Key>()(k);
+    }
+    template<typename Key>
+    std::size_t key_hash(const Key& k, std::enable_if_t<std::is_enum<Key>::value>* = 0)
+    {
+        typedef std::underlying_type_t<Key> underlying_type;
+        return std::hash<underlying_type>()(static_cast<underlying_type>(k));
+    }
+
+    /// Trait to return true if an expected value can be converted to Key without breaking
+    /// `actual == expected` implies `Key(actual) == Key(expected)`
+    template<typename Key, typename Expected>
+    struct is_key_compatible :
+        std::integral_constant<bool,
+                               is_key<Key>::value &&
+                                 (std::is_same<Key, Expected>::value ||
+                                  (std::is_integral<Key>::value && std::is_integral<Expected>::value) ||
+                                  (std::is_same<Key, std::string>::value &&
+                                   std::is_convertible<Expected, const char*>::value))>
+    {};
+
+    /// Computes the hash of the value an argument is constrained to be equal to, if any
+    template<typename Actual, typename Expected, typename Enable = void>
+    struct equality_key
+    {
+        static bool hash(const Expected&, std::size_t&) { return false; }
+    };
+    template<typename Actual, typename Expected>
+    struct equality_key<
+      Actual,
+      Expected,
+      std::enable_if_t<is_key_compatible<std::decay_t<Actual>, Expected>::value &&
+                       !is_functor<Expected, Actual>::value>>
+    {
+        static bool hash(const Expected& e, std::size_t& h)
+        {
+            typedef std::decay_t<Actual> key_type;
+            if(!valid(e))
+                return false;
+            h = key_hash<key_type>(static_cast<key_type>(e));
+            return true;
+        }
+
+    private:
+        template<typename T>
+        static bool valid(T* t)
+        {
+            return t != nullptr;
+        }
+        template<typename T>
+        static bool valid(const T&)
+        {
+            return true;
+        }
+    };
+    // mock::equal keeps a reference to lvalues which could change after the expectation has been set
+    template<typename Actual, typename Expected>
+    struct equality_key<Actual,
+                        constraint<equal<Expected>>,
+                        std::enable_if_t<!std::is_reference<Expected>::value &&
+                                         is_key_compatible<std::decay_t<Actual>, std::decay_t<Expected>>::value>>
+    {
+        static bool hash(const constraint<equal<Expected>>& c, std::size_t& h)
+        {
+            return equality_key<Actual, std::decay_t<Expected>>::hash(c.c_.expected_, h);
+        }
+    };
+
+    /// Trait to return true if all the values of T convert exactly to double
+    template<typename T>
+    struct is_range_key :
+        std::integral_constant<bool,
+                               (std::is_floating_point<T>::value ||
+                                (std::is_integral<T>::value && !std::is_same<T, bool>::value)) &&
+                                 std::numeric_limits<T>::digits <= std::numeric_limits<double>::digits>
+    {};
+
+    /// Enumerates the values of T in increasing order, NaNs excluded
+    template<typename T, typename Enable = void>
+    struct ordered_values
+    {
+        static std::uint64_t last() { return index(std::numeric_limits<T>::max()); }
+        static std::uint64_t index(T t)
+        {
+            return static_cast<std::uint64_t>(static_cast<std::int64_t>(t) - std::numeric_limits<T>::min());
+        }
+        static T value(std::uint64_t i)
+        {
+            return static_cast<T>(static_cast<std::int64_t>(i) + std::numeric_limits<T>::min());
+        }
+    };
+    template<typename T>
+    struct ordered_values<T, std::enable_if_t<std::is_floating_point<T>::value>>
+    {
+        // ordering the bit patterns of negative values backwards makes them follow the order of the values
+        typedef std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t> bits_type;
+        static_assert(sizeof(T) == sizeof(bits_type), "unsupported floating point type");
+        static constexpr bits_type sign = bits_type(1) << (8 * sizeof(T) - 1);
+
+        static std::uint64_t last() { return index(std::numeric_limits<T>::infinity()); }
+        static std::uint64_t index(T t)
+        {
+            bits_type b;
+            std::memcpy(&b, &t, sizeof(T));
+            return ((b & sign) ? bits_type(~b) : bits_type(b | sign)) - first();
+        }
+        static T value(std::uint64_t i)
+        {
+            const bits_type o = static_cast<bits_type>(i + first());
+            const bits_type b = (o & sign) ? bits_type(o & ~sign) : bits_type(~o);
+            T t;
+            std::memcpy(&t, &b, sizeof(T));
+            return t;
+        }
+
+    private:
+        static std::uint64_t first()
+        {
+            const T t = -std::numeric_limits<T>::infinity();
+            bits_type b;
+            std::memcpy(&b, &t, sizeof(T));
+            return bits_type(~b);
+        }
+    };
+
+    /// Returns the first index in [first, last] of a value of T satisfying `p`, or `last + 1`
+    /// `p` must be false then true over the values.
+    template<typename T, typename Predicate>
+    std::uint64_t first_satisfying(std::uint64_t first, std::uint64_t last, Predicate p)
+    {
+        std::uint64_t count = last - first + 1;
+        while(count > 0)
+        {
+            const std::uint64_t step = count / 2;
+            if(p(ordered_values<T>::value(first + step)))
+                count = step;
+            else
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+        }
+        return first;
+    }
+
+    /// Computes the bounds of the values of the first argument a constraint is satisfied by, if it amounts to a range
+    template<typename Actual, typename Constraint, typename Enable = void>
+    struct range_bounds : std::false_type
+    {
+        static bool compute(const Constraint&, double&, double&) { return false; }
+    };
+    template<typename Actual, typename Constraint>
+    struct range_bounds<Actual,
+                        Constraint,
+                        std::enable_if_t<is_range_key<Actual>::value &&
+                                         constraint_monotony<Actual, Constraint>::value != monotony::none>> :
+        std::true_type
+    {
+        static bool compute(const Constraint& c, double& lower, double& upper)
+        {
+            typedef ordered_values<Actual> values;
+            std::uint64_t first = 0, last = values::last();
+            if(!span(c, first, last, constraint_monotony<Actual, Constraint>()) || last + 1 == first ||
+               !c(values::value(first)) || !c(values::value(last)))
+                return false;
+            lower = static_cast<double>(values::value(first));
+            upper = static_cast<double>(values::value(last));
+            return true;
+        }
+
+    private:
+        template<monotony M>
+        using tag = std::integral_constant<monotony, M>;
+
+        static bool span(const Constraint& c, std::uint64_t& first, std::uint64_t last, tag<monotony::increasing>)
+        {
+            first = first_satisfying<Actual>(first, last, [&c](const Actual& a) { return c(a); });
+            return true;
+        }
+        static bool span(const Constraint& c, std::uint64_t first, std::uint64_t& last, tag<monotony::decreasing>)
+        {
+            last = first_satisfying<Actual>(first, last, [&c](const Actual& a) { return !c(a); }) - 1;
+            return true;
+        }
+        static bool span(const Constraint& c, std::uint64_t& first, std::uint64_t& last, tag<monotony::unimodal>)
+        {
+            // only near is unimodal, around its expected value
+            const Actual peak = static_cast<Actual>(c.expected0);
+            if(!c(peak))
+                return false;
+            const std::uint64_t middle = ordered_values<Actual>::index(peak);
+            first = first_satisfying<Actual>(first, middle, [&c](const Actual& a) { return c(a); });
+            last = first_satisfying<Actual>(middle, last, [&c](const Actual& a) { return !c(a); }) - 1;
+            return true;
+        }
+    };
+    template<typename Actual, typename Lhs, typename Rhs>
+    struct range_bounds<Actual,
+                        and_<Lhs, Rhs>,
+                        std::enable_if_t<range_bounds<Actual, Lhs>::value && range_bounds<Actual, Rhs>::value>> :
+        std::true_type
+    {
+        static bool compute(const and_<Lhs, Rhs>& c, double& lower, double& upper)
+        {
+            double l, u;
+            if(!range_bounds<Actual, Lhs>::compute(c.lhs(), lower, upper) ||
+               !range_bounds<Actual, Rhs>::compute(c.rhs(), l, u))
+                return false;
+            lower = std::max(lower, l);
+            upper = std::min(upper, u);
+            return lower <= upper;
+        }
+    };
+
+    /// Computes the bounds of the range of values the first argument is constrained to be in, if any
+    /// The bounds are only computed when first needed to build an index, and then kept.
+    template<typename Actual, typename Constraint, typename Enable = void>
+    class range_key
+    {
+    public:
+        explicit range_key(const Constraint&) {}
+        bool bounds(double&, double&) const { return false; }
+    };
+    template<typename Actual, typename Constraint>
+    class range_key<Actual,
+                    constraint<Constraint>,
+                    std::enable_if_t<range_bounds<std::decay_t<Actual>, Constraint>::value>>
+    {
+    public:
+        explicit range_key(const constraint<Constraint>& c) : c_(c.c_), computed_(false) {}
+        bool bounds(double& lower, double& upper) const
+        {
+            if(!computed_)
+            {
+                if(!range_bounds<std::decay_t<Actual>, Constraint>::compute(c_, lower_, upper_))
+                {
+                    lower_ = 1;
+                    upper_ = 0;
+                }
+                computed_ = true;
+            }
+            lower = lower_;
+            upper = upper_;
+            return lower_ <= upper_;
+        }
+
+    private:
+        Constraint c_;
+        // an empty range when the constraint does not amount to one
+        mutable double lower_, upper_;
+        mutable bool computed_;
+    };
+
+    template<typename T>
+    double range_value(const T& t, std::enable_if_t<is_range_key<T>::value>* = 0)
+    {
+        return static_cast<double>(t);
+    }
+    template<typename T>
+    double range_value(const T&, std::enable_if_t<!is_range_key<T>::value>* = 0)
+    {
+        return 0;
+    }
+
+    /// Computes the hash and range value of the first argument of a call
+    template<typename... Args>
+    struct first_key : std::false_type
+    {};
+    template<typename Arg, typename... Args>
+    struct first_key<Arg, Args...> : is_key<std::decay_t<Arg>>
+    {
+        template<typename... Ts>
+        static std::size_t hash(const std::decay_t<Arg>& arg, const Ts&...)
+        {
+            return key_hash(arg);
+        }
+        template<typename... Ts>
+        static double range(const std::decay_t<Arg>& arg, const Ts&...)
+        {
+            return range_value(arg);
+        }
+    };
+
+    /// Buckets expectations by the hash of the value their first argument is constrained to be equal to.
+    /// Expectations constraining their first argument to a range of values keep their bounds in columns,
+    /// scanned all at once on every call.
+    /// Other expectations are kept aside to be checked on every call.
+    template<typename Expectation>
+    class expectation_index
+    {
+    public:
+        template<typename Container>
+        void build(const Container& expectations)
+        {
+            clear();
+            std::size_t order = 0;
+            for(Expectation* expectation : expectations)
+            {
+                const entry e = { order++, expectation };
+                std::size_t key;
+                double lower, upper;
+                if(expectation->key(key))
+                    keyed_[key].push_back(e);
+                else if(expectation->range(lower, upper))
+                {
+                    ranged_.push_back(e);
+                    lower_.push_back(lower);
+                    upper_.push_back(upper);
+                } else
+                    others_.push_back(e);
+            }
+        }
+        void clear()
+        {
+            keyed_.clear();
+            ranged_.clear();
+            lower_.clear();
+            upper_.clear();
+            others_.clear();
+        }
+
+        /// Returns the first expectation in declaration order which may match a call with `key` and `value`
+        /// and satisfies `p`, or a null pointer
+        /// Exhausted expectations encountered on the way are skipped and counted in `skipped`.
+        template<typename Predicate>
+        Expectation* find(std::size_t key, double value, Predicate p, std::size_t& skipped) const
+        {
+            static const std::size_t none = std::numeric_limits<std::size_t>::max();
+            static const std::vector<entry> empty;
+            const auto it = keyed_.find(key);
+            const std::vector<entry>& keyed = it == keyed_.end() ? empty : it->second;
+            std::size_t k = 0, r = scan(0, value), o = 0;
+            for(;;)
+            {
+                const std::size_t keyed_order = k != keyed.size() ? keyed[k].order : none;
+                const std::size_t ranged_order = r != ranged_.size() ? ranged_[r].order : none;
+                const std::size_t other_order = o != others_.size() ? others_[o].order : none;
+                const std::size_t order = std::min(std::min(keyed_order, ranged_order), other_order);
+                if(order == none)
+                    return nullptr;
+                const bool next_ranged = order == ranged_order;
+                const std::vector<entry>& entries = next_ranged ? ranged_ : order == keyed_order ? keyed : others_;
+                std::size_t& i = next_ranged ? r : order == keyed_order ? k : o;
+                Expectation* e = entries[i].e;
+                if(e->exhausted())
+                    ++skipped;
+                else if(p(*e))
+                    return e;
+                i = next_ranged ? scan(i + 1, value) : i + 1;
+            }
+        }
+
+    private:
+        struct entry
+        {
+            std::size_t order;
+            Expectation* e;
+        };
+
+        std::size_t scan(std::size_t first, double value) const
+        {
+            return scan_ranges(lower_.data(), upper_.data(), first, lower_.size(), value);
+        }
+
+        std::unordered_map<std::size_t, std::vector<entry>> keyed_;
+        std::vector<entry> ranged_;
+        std::vector<double> lower_, upper_;
+        std::vector<entry> others_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_EXPECTATION_INDEX_HPP_INCLUDED
@@ -34,11 +34,16 @@ namespace mock { namespace detail {
     public:
         function() : impl_(std::make_shared<impl_type>()) {}
 
-        bool verify() const { return impl_->verify(); }
+        /// Calls buffered from other threads are reported first, before taking any lock
+        bool verify() const
+        {
+            flush_calls();
+            return impl_->verify();
+        }
         bool verify(const char* file, int line) const
         {
             error_type::pass(file, line);
-            return impl_->verify();
+            return verify();
         }
         void reset() { impl_->reset(); }
         void reset(const char* file, int line)
@@ -47,6 +52,20 @@ namespace mock { namespace detail {
             impl_->reset();
         }
 
+        void index() { impl_->index(); }
+        void index(const char* file, int line)
+        {
+            error_type::pass(file, line);
+            impl_->index();
+        }
+
+        void freeze() { impl_->freeze(); }
+        void freeze(const char* file, int line)
+        {
+            error_type::pass(file, line);
+            impl_->freeze();
+        }
+
         expectation_type expect(const char* file, int line)
         {
             error_type::pass(file, line);
@@ -55,6 +74,9 @@ namespace mock { namespace detail {
         expectation_type expect() { return impl_->expect(); }
 
         R operator()(Ts... args) const { return (*impl_)(static_cast<ref_arg_t<Ts>>(args)...); }
+        /// Same as calling the function but taking arguments by reference,
+        /// for mocked methods which already hold a copy of the arguments passed by value
+        R forward(ref_arg_t<Ts>... args) const { return (*impl_)(static_cast<ref_arg_t<Ts>>(args)...); }
 
         friend std::ostream& operator<<(std::ostream& s, const function& f) { return s << *f.impl_; }
 
@@ -64,6 +86,9 @@ namespace mock { namespace detail {
             return *this;
         }
 
+        /// Returns true once added to a context
+        bool registered() const { return impl_->registered(); }
+
         void configure(context& c,
                        const void* p,
                        boost::unit_test::const_string instance,
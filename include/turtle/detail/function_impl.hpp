@@ -10,12 +10,18 @@
 #define MOCK_FUNCTION_IMPL_HPP_INCLUDED
 
 #include "../error.hpp"
+#include "arena.hpp"
+#include "context.hpp"
 #include "expectation.hpp"
+#include "expectation_index.hpp"
 #include "mutex.hpp"
+#include "segmented_vector.hpp"
+#include "type_name.hpp"
 #include "verifiable.hpp"
 #include <boost/test/utils/lazy_ostream.hpp>
-#include <list>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #ifndef MOCK_ERROR_POLICY
 #    error no error policy has been set
@@ -80,12 +86,18 @@ namespace mock { namespace detail {
         typedef safe_error<R, MOCK_ERROR_POLICY<R>> error_type;
 
     public:
-        function_impl() : context_(0), valid_(true), exceptions_(exceptions()), mutex_(std::make_shared<mutex>()) {}
+        function_impl()
+            : context_(0), valid_(true), indexed_(false), frozen_(false), stale_(false), dropped_(false),
+              exceptions_(exceptions()), storage_(std::make_shared<storage>()),
+              mutex_(std::make_shared<shared_mutex>())
+        {}
         virtual ~function_impl()
         {
+            // Calls buffered from other threads refer to this function
+            flush_calls();
             if(valid_ && exceptions_ >= exceptions())
             {
-                for(const auto& expectation : expectations_)
+                for(const auto& expectation : storage_->expectations_)
                 {
                     if(!expectation.verify())
                     {
@@ -97,14 +109,14 @@ namespace mock { namespace detail {
                     }
                 }
             }
-            if(context_)
-                context_->remove(*this);
+            if(context* c = context_)
+                c->remove(*this);
         }
 
         virtual bool verify() const
         {
-            lock _(mutex_);
-            for(const auto& expectation : expectations_)
+            exclusive_lock _(*mutex_);
+            for(const auto& expectation : storage_->expectations_)
             {
                 if(!expectation.verify())
                 {
@@ -121,15 +133,61 @@ namespace mock { namespace detail {
 
         virtual void reset()
         {
-            lock _(mutex_);
-            valid_ = true;
+            // Keeps the mutex alive until unlocked should clearing the expectations release the last reference
             std::shared_ptr<function_impl> guard = this->shared_from_this();
-            expectations_.clear();
+            exclusive_lock _(*mutex_);
+            valid_ = true;
+            live_.clear();
+            index_.clear();
+            frozen_ = false;
+            stale_ = false;
+            dropped_ = false;
+            if(storage_.use_count() == 1)
+            {
+                // No action is running, synchronize with the calls which ran one before reusing the storage
+                std::atomic_thread_fence(std::memory_order_acquire);
+                storage_->expectations_.clear();
+                storage_->arena_.clear();
+            } else
+                // The calls running an action release the expectations once done
+                storage_ = std::make_shared<storage>();
+        }
+
+        /// Compile the current expectations into a read-only dispatch table
+        /// Expectations exhausted at this point are left out and the table is indexed by the value the first
+        /// argument is expected to be equal to if supported.
+        /// Adding or modifying an expectation afterwards unfreezes the function.
+        virtual void freeze()
+        {
+            exclusive_lock _(*mutex_);
+            frozen_ = true;
+            stale_ = true;
+            refresh();
+        }
+
+        /// Look up expectations by the value their first argument is expected to be equal to
+        /// instead of trying them all in turn
+        /// Has no effect if the type of the first argument is not supported as a key
+        void index()
+        {
+            exclusive_lock _(*mutex_);
+            indexed_ = first_key<Args...>::value;
+            frozen_ = false;
+            stale_ = true;
         }
 
     private:
         typedef expectation<R(Args...)> expectation_type;
 
+        /// Expectations along with the storage of their large matchers and values
+        /// In thread safe mode calls running an action share it, resetting or destroying the function meanwhile
+        /// leaves it alive.
+        struct storage
+        {
+            arena arena_;
+            segmented_vector<expectation_type> expectations_;
+        };
+
         class wrapper : public wrapper_base<R, expectation_type>
         {
         private:
@@ -137,39 +195,39 @@ namespace mock { namespace detail {
             static constexpr std::size_t arity = sizeof...(Args);
 
         public:
-            wrapper(const std::shared_ptr<mutex>& m, expectation_type& e) : base_type(e), lock_(m) {}
+            wrapper(function_impl& impl, expectation_type& e) : base_type(e), impl_(&impl), lock_(impl.mutex_) {}
             wrapper(const wrapper&) = delete;
             wrapper(wrapper&& x) = default;
             wrapper& operator=(const wrapper&) = delete;
             wrapper& operator=(wrapper&& x) = default;
             wrapper& once()
             {
-                this->e_->invoke(std::make_unique<detail::once>());
+                invoke(detail::once());
                 return *this;
             }
             wrapper& never()
             {
-                this->e_->invoke(std::make_unique<detail::never>());
+                invoke(detail::never());
                 return *this;
             }
             wrapper& exactly(std::size_t count)
             {
-                this->e_->invoke(std::make_unique<detail::exactly>(count));
+                invoke(detail::exactly(count));
                 return *this;
             }
             wrapper& at_least(std::size_t min)
             {
-                this->e_->invoke(std::make_unique<detail::at_least>(min));
+                invoke(detail::at_least(min));
                 return *this;
             }
             wrapper& at_most(std::size_t max)
             {
-                this->e_->invoke(std::make_unique<detail::at_most>(max));
+                invoke(detail::at_most(max));
                 return *this;
             }
             wrapper& between(std::size_t min, std::size_t max)
             {
-                this->e_->invoke(std::make_unique<detail::between>(min, max));
+                invoke(detail::between(min, max));
                 return *this;
             }
 
@@ -182,6 +240,9 @@ namespace mock { namespace detail {
             with(Constraints... c)
             {
                 this->e_->with(c...);
+                if(impl_->indexed_)
+                    impl_->stale_ = true;
+                impl_->frozen_ = false;
                 return *this;
             }
 
@@ -197,7 +258,7 @@ namespace mock { namespace detail {
             template<typename TT>
             void calls(TT t)
             {
-                this->e_->calls(t);
+                this->e_->calls(std::move(t));
             }
             template<typename TT>
             void throws(TT t)
@@ -210,6 +271,17 @@ namespace mock { namespace detail {
                 this->e_->moves(std::move(t));
             }
 
+        private:
+            void invoke(const invocation& i)
+            {
+                this->e_->invoke(i);
+                // The expectation may not be exhausted anymore
+                if(impl_->dropped_)
+                    impl_->stale_ = true;
+                impl_->frozen_ = false;
+            }
+
+            function_impl* impl_;
             lock lock_;
         };
 
@@ -218,72 +290,160 @@ namespace mock { namespace detail {
 
         wrapper expect(const char* file, int line)
         {
-            lock _(mutex_);
-            expectations_.emplace_back(file, line);
+            exclusive_lock _(*mutex_);
+            expectation_type& e = storage_->expectations_.emplace_back(storage_->arena_, file, line);
             valid_ = true;
-            return wrapper(mutex_, expectations_.back());
+            live_.push_back(&e);
+            if(indexed_)
+                stale_ = true;
+            frozen_ = false;
+            return wrapper(*this, e);
         }
         wrapper expect()
         {
-            lock _(mutex_);
-            expectations_.emplace_back();
+            exclusive_lock _(*mutex_);
+            expectation_type& e = storage_->expectations_.emplace_back(storage_->arena_);
             valid_ = true;
-            return wrapper(mutex_, expectations_.back());
+            live_.push_back(&e);
+            if(indexed_)
+                stale_ = true;
+            frozen_ = false;
+            return wrapper(*this, e);
         }
 
-        R operator()(Args... args) const
+        R operator()(ref_arg_t<Args>... args) const
         {
 // Due to lifetime rules of references this must be created and consumed in one line
 #define MOCK_FUNCTION_CONTEXT                  \
     boost::unit_test::lazy_ostream::instance() \
       << lazy_context(this) << lazy_args<Args...>(args...) << lazy_expectations(this)
 
-            lock _(mutex_);
-            valid_ = false;
-            for(const auto& expectation : expectations_)
+            const expectation_type* expectation;
+#ifdef MOCK_THREAD_SAFE
+            std::shared_ptr<const storage> alive;
+#endif
             {
-                if(expectation.is_valid(static_cast<ref_arg_t<Args>>(args)...))
+                // Calls only share the lock, expectations being selected and consumed concurrently
+                shared_lock _(*mutex_);
+                while(stale_.load(std::memory_order_relaxed))
                 {
-                    if(!expectation.invoke())
-                    {
-                        error_type::fail(
-                          "sequence failed", MOCK_FUNCTION_CONTEXT, expectation.file(), expectation.line());
-                        return error_type::abort();
-                    }
-                    if(!expectation.valid())
+                    // Upgrading gives up the shared lock in between, another call may have refreshed already
+                    exclusive_lock upgrade(*mutex_);
+                    if(stale_.load(std::memory_order_relaxed))
+                        refresh();
+                }
+                valid_.store(false, std::memory_order_relaxed);
+                for(;;)
+                {
+                    std::size_t skipped = 0;
+                    expectation = find(first_key<Args...>{}, skipped, static_cast<ref_arg_t<Args>>(args)...);
+                    if(skipped > max_skipped && !frozen_)
+                        stale_.store(true, std::memory_order_relaxed);
+                    if(!expectation)
                     {
-                        error_type::fail(
-                          "missing action", MOCK_FUNCTION_CONTEXT, expectation.file(), expectation.line());
+                        error_type::fail("unexpected call", MOCK_FUNCTION_CONTEXT);
                         return error_type::abort();
                     }
-                    valid_ = true;
-                    error_type::call(MOCK_FUNCTION_CONTEXT, expectation.file(), expectation.line());
-                    if(expectation.functor())
-                        return expectation.functor()(static_cast<ref_arg_t<Args>>(args)...);
-                    return expectation.trigger();
+                    if(expectation->invoke())
+                        break;
+                    // Another thread consumed the last allowed call in between
+                    if(expectation->exhausted())
+                        continue;
+                    error_type::fail(
+                      "sequence failed", MOCK_FUNCTION_CONTEXT, expectation->file(), expectation->line());
+                    return error_type::abort();
+                }
+                if(!expectation->valid())
+                {
+                    error_type::fail("missing action", MOCK_FUNCTION_CONTEXT, expectation->file(), expectation->line());
+                    return error_type::abort();
                 }
+                valid_.store(true, std::memory_order_relaxed);
+                error_type::template call<lazy_buffered>(
+                  MOCK_FUNCTION_CONTEXT, this, expectation->file(), expectation->line());
+                // Returning a value stored in the expectation is cheap enough to be done locked
+                if(!expectation->functor() && expectation->is_inline())
+                    return expectation->trigger();
+#ifdef MOCK_THREAD_SAFE
+                // Resetting or destroying the function from another thread must leave the action alive
+                alive = storage_;
+#endif
             }
-            error_type::fail("unexpected call", MOCK_FUNCTION_CONTEXT);
-            return error_type::abort();
+            // The action runs unlocked, it may call or set up the mock again from this or any other thread
+            if(expectation->functor())
+                return expectation->functor()(static_cast<ref_arg_t<Args>>(args)...);
+            return expectation->trigger();
 #undef MOCK_FUNCTION_CONTEXT
         }
 
+    private:
+        /// Number of exhausted expectations a call can skip before live_ and index_ get rebuilt
+        static constexpr std::size_t max_skipped = 8;
+
+        /// Must be called with the mutex locked exclusively
+        void refresh() const
+        {
+            live_.clear();
+            for(const auto& expectation : storage_->expectations_)
+                if(!expectation.exhausted())
+                    live_.push_back(&expectation);
+            if(first_key<Args...>::value && (indexed_ || frozen_))
+                index_.build(live_);
+            stale_ = false;
+            dropped_ = live_.size() != storage_->expectations_.size();
+        }
+
+        const expectation_type* find(std::true_type, std::size_t& skipped, ref_arg_t<Args>... args) const
+        {
+            if(!indexed_ && !frozen_)
+                return find(std::false_type(), skipped, static_cast<ref_arg_t<Args>>(args)...);
+            return index_.find(
+              first_key<Args...>::hash(args...),
+              first_key<Args...>::range(args...),
+              [&](const expectation_type& e) { return is_valid(e, static_cast<ref_arg_t<Args>>(args)...); },
+              skipped);
+        }
+        const expectation_type* find(std::false_type, std::size_t& skipped, ref_arg_t<Args>... args) const
+        {
+            for(const expectation_type* expectation : live_)
+            {
+                if(expectation->exhausted())
+                    ++skipped;
+                else if(is_valid(*expectation, static_cast<ref_arg_t<Args>>(args)...))
+                    return expectation;
+            }
+            return nullptr;
+        }
+        bool is_valid(const expectation_type& e, ref_arg_t<Args>... args) const
+        {
+            if(e.is_stateless())
+                return e.is_valid(static_cast<ref_arg_t<Args>>(args)...);
+            // Constraints which may modify the arguments or any state are evaluated by one call at a time
+            scoped_lock _(stateful_mutex_);
+            return e.is_valid(static_cast<ref_arg_t<Args>>(args)...);
+        }
+
+    public:
         void add(context& c,
                  const void* p,
                  boost::unit_test::const_string instance,
                  boost::optional<type_name> type,
                  boost::unit_test::const_string name)
         {
-            lock _(mutex_);
+            exclusive_lock _(*mutex_);
             if(!context_)
                 c.add(*this);
             c.add(p, *this, instance, type, name);
             context_ = &c;
         }
 
+        /// Returns true once added to a context
+        /// Later anonymous calls leave the naming unchanged and can skip adding the function again.
+        bool registered() const { return context_ != nullptr; }
+
         friend std::ostream& operator<<(std::ostream& s, const function_impl& impl)
         {
-            lock _(impl.mutex_);
+            shared_lock _(*impl.mutex_);
             return s << lazy_context(&impl) << lazy_expectations(&impl);
         }
 
@@ -292,8 +452,8 @@ namespace mock { namespace detail {
             lazy_context(const function_impl* impl) : impl_(impl) {}
             friend std::ostream& operator<<(std::ostream& s, const lazy_context& c)
             {
-                if(c.impl_->context_)
-                    c.impl_->context_->serialize(s, *c.impl_);
+                if(context* ctx = c.impl_->context_)
+                    ctx->serialize(s, *c.impl_);
                 else
                     s << '?';
                 return s;
@@ -301,23 +461,48 @@ namespace mock { namespace detail {
             const function_impl* impl_;
         };
 
+        /// Context of a call buffered from another thread, only its arguments are not known anymore
+        struct lazy_buffered
+        {
+            explicit lazy_buffered(const void* impl) : impl_(static_cast<const function_impl*>(impl)) {}
+            friend std::ostream& operator<<(std::ostream& s, const lazy_buffered& b)
+            {
+                s << lazy_context(b.impl_) << '(';
+                for(std::size_t i = 0; i < sizeof...(Args); ++i)
+                    s << (i ? ", ?" : " ?");
+                return s << (sizeof...(Args) ? " )" : ")") << " (buffered call from another thread)";
+            }
+            const function_impl* impl_;
+        };
+
         struct lazy_expectations
         {
             lazy_expectations(const function_impl* impl) : impl_(impl) {}
             friend std::ostream& operator<<(std::ostream& s, const lazy_expectations& e)
             {
-                for(const auto& expectation : e.impl_->expectations_)
+                for(const auto& expectation : e.impl_->storage_->expectations_)
                     s << std::endl << expectation;
                 return s;
             }
             const function_impl* impl_;
         };
 
-        std::list<expectation_type> expectations_;
-        context* context_;
-        mutable bool valid_;
+        /// Expectations which were not exhausted yet in declaration order, rebuilt once calls skip too many
+        mutable std::vector<const expectation_type*> live_;
+        mutable expectation_index<const expectation_type> index_;
+        std::atomic<context*> context_;
+        mutable std::atomic<bool> valid_;
+        bool indexed_;
+        /// live_ and index_ are kept as is until an expectation is added or modified
+        bool frozen_;
+        /// live_ and index_ need to be rebuilt from expectations_
+        mutable std::atomic<bool> stale_;
+        /// Some exhausted expectations are missing from live_ or index_
+        mutable bool dropped_;
         const int exceptions_;
-        const std::shared_ptr<mutex> mutex_;
+        std::shared_ptr<storage> storage_;
+        const std::shared_ptr<shared_mutex> mutex_;
+        mutable mutex stateful_mutex_;
     };
 
     template<typename ArgFirst, typename... ArgRest>
@@ -11,42 +11,43 @@
 
 #include "../config.hpp"
 #include "function.hpp"
-#include "mutex.hpp"
-#include "singleton.hpp"
 
 namespace mock { namespace detail {
-    class functor_mutex_t : public singleton<functor_mutex_t>, public mutex
-    {
-        MOCK_SINGLETON_CONS(functor_mutex_t);
-    };
-    MOCK_SINGLETON_INST(functor_mutex)
-
     template<typename Signature>
     struct functor : function<Signature>
     {
-        functor()
+        // MOCK_FUNCTOR creates 2 functor objects:
+        // The user-usable one with the passed name and a 2nd used by MOCK_EXPECT with a suffixed name
+        // Both are constructed one after the other by the same thread, so the 2nd shares the implementation of
+        // the first using a thread local pointer without locking anything.
+        functor() : function<Signature>(pair(this)) {}
+        functor(const functor&) = default;
+        functor& operator=(const functor&) = default;
+        ~functor()
         {
-            scoped_lock _(functor_mutex);
-            // MOCK_FUNCTOR creates 2 functor objects:
-            // The user-usable one with the passed name and a 2nd used by MOCK_EXPECT with a suffixed name
-            // We need the 2nd to be a copy of the first and use a static variable for storing a pointer to the first
-            static functor* f = nullptr;
-            if(f)
-            {
-                // Release the lock from the first call (see below) so other threads can create functors again
-                // after the function exits (the scoped_lock still holds the mutex)
-                functor_mutex.unlock();
-                // Copy the first functor to the current (2nd) one
-                *this = *f;
-                f = nullptr;
-            } else
+            // Do not leave a dangling pointer if the 2nd functor never gets constructed
+            if(first() == this)
+                first() = nullptr;
+        }
+
+    private:
+        static function<Signature> pair(functor* f)
+        {
+            functor*& pending = first();
+            if(!pending)
             {
-                // This is the first object, store its pointer
-                f = this;
-                // Lock the mutex again so only this thread can create new instances of a functor
-                // making sure that we copy the right instance above and not one from a concurrent thread
-                functor_mutex.lock();
+                pending = f;
+                return function<Signature>();
             }
+            function<Signature> shared = *pending;
+            pending = nullptr;
+            return shared;
+        }
+        /// First functor of a pair whose 2nd one has not been constructed yet by the current thread
+        static functor*& first()
+        {
+            static thread_local functor* f = nullptr;
+            return f;
         }
     };
 }} // namespace mock::detail
@@ -40,6 +40,11 @@ namespace mock { namespace detail {
                 if(std::find(verifiables_.begin(), verifiables_.end(), verifiable) != verifiables_.end())
                     verifiable->reset();
         }
+        void freeze()
+        {
+            for(auto* verifiable : verifiables_)
+                verifiable->freeze();
+        }
 
     private:
         std::vector<verifiable*> verifiables_;
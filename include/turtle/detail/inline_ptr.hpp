@@ -0,0 +1,108 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_INLINE_PTR_HPP_INCLUDED
+#define MOCK_INLINE_PTR_HPP_INCLUDED
+
+#include "../config.hpp"
+#include "arena.hpp"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mock { namespace detail {
+    /// Owning pointer to a polymorphic object constructed in place.
+    /// Objects of up to `Size` bytes are stored in an internal buffer, larger ones on the heap or in an arena.
+    template<typename Base, std::size_t Size>
+    class inline_ptr
+    {
+        typedef std::aligned_storage_t<Size> storage;
+
+        template<typename T>
+        using fits = std::integral_constant<bool, sizeof(T) <= Size && alignof(T) <= alignof(storage)>;
+
+        enum class placement : unsigned char
+        {
+            none,
+            buffer,
+            heap,
+            arena
+        };
+
+    public:
+        inline_ptr() : ptr_(nullptr), placement_(placement::none) {}
+        inline_ptr(const inline_ptr&) = delete;
+        inline_ptr& operator=(const inline_ptr&) = delete;
+        ~inline_ptr() { reset(); }
+
+        /// Destroys the current object and constructs a `T` from `ts`
+        /// Left empty if the construction throws.
+        template<typename T, typename... Ts>
+        T& emplace(Ts&&... ts)
+        {
+            static_assert(std::is_base_of<Base, T>::value, "T must derive from Base");
+            reset();
+            T* t = construct<T>(fits<T>(), std::forward<Ts>(ts)...);
+            ptr_ = t;
+            placement_ = fits<T>::value ? placement::buffer : placement::heap;
+            return *t;
+        }
+
+        /// Same as emplace but objects too large for the internal buffer are created in `a`
+        /// `a` must not be cleared before the object has been destroyed.
+        template<typename T, typename... Ts>
+        T& emplace_in(arena& a, Ts&&... ts)
+        {
+            static_assert(std::is_base_of<Base, T>::value, "T must derive from Base");
+            if(fits<T>::value)
+                return emplace<T>(std::forward<Ts>(ts)...);
+            reset();
+            T* t = a.create<T>(std::forward<Ts>(ts)...);
+            ptr_ = t;
+            placement_ = placement::arena;
+            return *t;
+        }
+
+        void reset()
+        {
+            if(placement_ == placement::heap)
+                delete ptr_;
+            else if(placement_ != placement::none)
+                ptr_->~Base();
+            ptr_ = nullptr;
+            placement_ = placement::none;
+        }
+
+        Base* get() const { return ptr_; }
+        Base* operator->() const { return ptr_; }
+        Base& operator*() const { return *ptr_; }
+        explicit operator bool() const { return ptr_ != nullptr; }
+
+        /// Returns true if the object is stored in the internal buffer
+        bool is_inline() const { return placement_ == placement::buffer; }
+
+    private:
+        template<typename T, typename... Ts>
+        T* construct(std::true_type, Ts&&... ts)
+        {
+            return new(&buffer_) T(std::forward<Ts>(ts)...);
+        }
+        template<typename T, typename... Ts>
+        T* construct(std::false_type, Ts&&... ts)
+        {
+            return new T(std::forward<Ts>(ts)...);
+        }
+
+        storage buffer_;
+        Base* ptr_;
+        placement placement_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_INLINE_PTR_HPP_INCLUDED
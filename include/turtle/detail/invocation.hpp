@@ -10,124 +10,109 @@
 #define MOCK_INVOCATION_HPP_INCLUDED
 
 #include "../config.hpp"
+#include "mutex.hpp"
+#include <cstddef>
 #include <limits>
 #include <ostream>
 #include <stdexcept>
 
 namespace mock { namespace detail {
+    /// Bounds on the number of times an expectation can be triggered along with its current count
+    /// Stored by value in the expectation, the derived classes only differ by how they initialize it.
     class invocation
     {
     public:
-        invocation() = default;
-        invocation(const invocation&) = delete;
-        invocation& operator=(const invocation&) = delete;
-
-        virtual ~invocation() = default;
-
-        virtual bool invoke() = 0;
-        virtual bool verify() const = 0;
-
-        virtual bool exhausted() const = 0;
-
-        friend std::ostream& operator<<(std::ostream& s, const invocation& i) { return i.serialize(s); }
-
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const = 0;
-    };
-
-    class between : public invocation
-    {
-    public:
-        between(std::size_t min, std::size_t max) : min_(min), max_(max), count_(0)
+        /// Returns false if the maximum count has been reached, possibly by another thread
+        bool invoke() { return count_.increment(max_); }
+        bool verify() const
         {
-            if(min > max)
-                throw std::invalid_argument("'min' > 'max'");
+            const std::size_t count = count_.get();
+            return min_ <= count && count <= max_;
         }
 
-        virtual bool invoke()
+        bool exhausted() const { return count_.get() >= max_; }
+
+        friend std::ostream& operator<<(std::ostream& s, const invocation& i)
         {
-            if(count_ == max_)
-                return false;
-            ++count_;
-            return true;
+            const std::size_t count = i.count_.get();
+            switch(i.kind_)
+            {
+                case kind::between: return s << "between( " << count << "/[" << i.min_ << ',' << i.max_ << "] )";
+                case kind::exactly: return s << "exactly( " << count << '/' << i.max_ << " )";
+                case kind::never: return s << "never()";
+                case kind::once: return s << "once()";
+                case kind::at_least: return s << "at_least( " << count << '/' << i.min_ << " )";
+                case kind::at_most: return s << "at_most( " << count << '/' << i.max_ << " )";
+                case kind::unlimited: return s << "unlimited()";
+            }
+            return s;
         }
 
-        virtual bool exhausted() const { return count_ >= max_; }
-
-        virtual bool verify() const { return min_ <= count_ && count_ <= max_; }
-
     protected:
-        const std::size_t min_, max_;
-        std::size_t count_;
-
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const
+        enum class kind : unsigned char
+        {
+            between,
+            exactly,
+            never,
+            once,
+            at_least,
+            at_most,
+            unlimited
+        };
+
+        invocation(kind k, std::size_t min, std::size_t max) : kind_(k), min_(min), max_(max)
         {
-            return s << "between( " << count_ << "/[" << min_ << ',' << max_ << "] )";
+            if(min > max)
+                throw std::invalid_argument("'min' > 'max'");
         }
+
+    private:
+        kind kind_;
+        std::size_t min_, max_;
+        bounded_counter count_;
     };
 
-    class exactly : public between
+    class between : public invocation
     {
     public:
-        explicit exactly(std::size_t count) : between(count, count) {}
-
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const
-        {
-            return s << "exactly( " << count_ << '/' << max_ << " )";
-        }
+        between(std::size_t min, std::size_t max) : invocation(kind::between, min, max) {}
     };
 
-    class never : public exactly
+    class exactly : public invocation
     {
     public:
-        never() : exactly(0) {}
-
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const { return s << "never()"; }
+        explicit exactly(std::size_t count) : invocation(kind::exactly, count, count) {}
     };
 
-    class once : public exactly
+    class never : public invocation
     {
     public:
-        once() : exactly(1) {}
-
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const { return s << "once()"; }
+        never() : invocation(kind::never, 0, 0) {}
     };
 
-    class at_least : public between
+    class once : public invocation
     {
     public:
-        explicit at_least(std::size_t min) : between(min, (std::numeric_limits<std::size_t>::max)()) {}
-
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const
-        {
-            return s << "at_least( " << count_ << '/' << min_ << " )";
-        }
+        once() : invocation(kind::once, 1, 1) {}
     };
 
-    class at_most : public between
+    class at_least : public invocation
     {
     public:
-        explicit at_most(std::size_t max) : between(0, max) {}
-
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const
-        {
-            return s << "at_most( " << count_ << '/' << max_ << " )";
-        }
+        explicit at_least(std::size_t min) : invocation(kind::at_least, min, (std::numeric_limits<std::size_t>::max)())
+        {}
     };
 
-    class unlimited : public at_least
+    class at_most : public invocation
     {
     public:
-        unlimited() : at_least(0) {}
+        explicit at_most(std::size_t max) : invocation(kind::at_most, 0, max) {}
+    };
 
-    private:
-        virtual std::ostream& serialize(std::ostream& s) const { return s << "unlimited()"; }
+    class unlimited : public invocation
+    {
+    public:
+        unlimited() : invocation(kind::unlimited, 0, (std::numeric_limits<std::size_t>::max)()) {}
     };
 }} // namespace mock::detail
 
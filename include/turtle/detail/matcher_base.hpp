@@ -10,6 +10,7 @@
 #define MOCK_MATCHER_BASE_HPP_INCLUDED
 
 #include "ref_arg.hpp"
+#include <cstddef>
 #include <ostream>
 
 namespace mock { namespace detail {
@@ -24,6 +25,17 @@ namespace mock { namespace detail {
 
         virtual bool operator()(ref_arg_t<Args>...) = 0;
 
+        /// Set `key` to the hash of the value the first argument must be equal to for a match
+        /// Returns false if there is no such value
+        virtual bool key(std::size_t& /*key*/) const { return false; }
+
+        /// Set `lower` and `upper` to the bounds of the range the first argument must be in for a match
+        /// Returns false if there is no such range
+        virtual bool range(double& /*lower*/, double& /*upper*/) const { return false; }
+
+        /// Returns true if matching can run concurrently with other calls, see stateless_constraint
+        virtual bool is_stateless() const { return true; }
+
         friend std::ostream& operator<<(std::ostream& s, const matcher_base& m)
         {
             m.serialize(s);
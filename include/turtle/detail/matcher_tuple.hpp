@@ -0,0 +1,96 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_MATCHER_TUPLE_HPP_INCLUDED
+#define MOCK_MATCHER_TUPLE_HPP_INCLUDED
+
+#include "../config.hpp"
+#include "../matcher.hpp"
+#include "ref_arg.hpp"
+#include <cstddef>
+#include <ostream>
+#include <tuple>
+#include <utility>
+
+namespace mock { namespace detail {
+    /// Returns the position of the i-th cheapest amongst Costs, keeping the declaration order for equal costs
+    template<evaluation_cost... Costs>
+    constexpr std::size_t by_cost(std::size_t i)
+    {
+        const evaluation_cost costs[] = { Costs... };
+        for(std::size_t j = 0; j < sizeof...(Costs); ++j)
+        {
+            std::size_t rank = 0;
+            for(std::size_t k = 0; k < sizeof...(Costs); ++k)
+            {
+                if(costs[k] < costs[j] || (costs[k] == costs[j] && k < j))
+                    ++rank;
+            }
+            if(rank == i)
+                return j;
+        }
+        return i;
+    }
+
+    /// Matches each argument of a call against its own constraint
+    template<typename ConstraintPack, typename... Args>
+    class matcher_tuple;
+
+    template<typename... Constraints, typename... Args>
+    class matcher_tuple<void(Constraints...), Args...>
+    {
+        static_assert(sizeof...(Constraints) == sizeof...(Args), "Need exactly 1 constraint per argument");
+
+        typedef std::tuple<ref_arg_t<Args>...> arguments_type;
+
+    public:
+        explicit matcher_tuple(Constraints... constraints) : matchers_(matcher<Args, Constraints>(constraints)...) {}
+
+        /// Evaluates the matchers from the cheapest to the most expensive, stopping at the first failure
+        bool operator()(ref_arg_t<Args>... t)
+        {
+            arguments_type args(static_cast<ref_arg_t<Args>>(t)...);
+            return is_valid_impl(decltype(evaluation_order(std::make_index_sequence<sizeof...(Args)>{})){}, args);
+        }
+
+        friend std::ostream& operator<<(std::ostream& s, const matcher_tuple& m)
+        {
+            m.serialize(std::make_index_sequence<sizeof...(Args)>{}, s);
+            return s;
+        }
+
+    private:
+        template<std::size_t I>
+        bool is_valid(arguments_type& args)
+        {
+            return std::get<I>(matchers_)(static_cast<std::tuple_element_t<I, arguments_type>>(std::get<I>(args)));
+        }
+        template<std::size_t... I>
+        bool is_valid_impl(std::index_sequence<I...>, arguments_type& args)
+        {
+            using expander = bool[];
+            bool result = true;
+            (void)expander{ true, (result = result && is_valid<I>(args))... };
+            return result;
+        }
+        template<std::size_t... I>
+        static auto evaluation_order(std::index_sequence<I...>)
+          -> std::index_sequence<by_cost<matcher_cost<matcher<Args, Constraints>>::value...>(I)...>;
+
+        template<std::size_t... I>
+        void serialize(std::index_sequence<I...>, std::ostream& s) const
+        {
+            using expander = int[];
+            (void)expander{ 0, (s << (I ? ", " : "") << std::get<I>(matchers_), 0)... };
+        }
+
+        std::tuple<matcher<Args, Constraints>...> matchers_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_MATCHER_TUPLE_HPP_INCLUDED
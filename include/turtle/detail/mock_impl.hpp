@@ -31,10 +31,19 @@ namespace mock { namespace detail {
     /// T is something like `void(std::map<int, float>)`
     template<typename T>
     using unwrap_signature_t = std::remove_pointer_t<typename arg_type<T>::type>;
+
+    /// Adds a mocked function or static method to the root context upon its first call only
+    template<typename F>
+    F& register_once(F& f, boost::unit_test::const_string instance)
+    {
+        if(!f.registered())
+            f(root, instance);
+        return f;
+    }
 }} // namespace mock::detail
 
 #define MOCK_HELPER(t) t##_mock(mock::detail::root, BOOST_PP_STRINGIZE(t))
-#define MOCK_ANONYMOUS_HELPER(t) t##_mock(mock::detail::root, "?.")
+#define MOCK_ANONYMOUS_HELPER(t) t##_mock_registered()
 
 #define MOCK_METHOD_HELPER(S, t)                                                                                      \
     mutable mock::detail::function<S> t##_mock_;                                                                      \
@@ -43,10 +52,16 @@ namespace mock { namespace detail {
     {                                                                                                                 \
         mock::detail::configure(*this,                                                                                \
                                 t##_mock_,                                                                            \
-                                instance.substr(0, instance.rfind(BOOST_PP_STRINGIZE(t))),                            \
+                                instance,                                                                             \
                                 mock::detail::make_type_name(*this),                                                  \
                                 BOOST_PP_STRINGIZE(t));                                                               \
         return t##_mock_;                                                                                             \
+    }                                                                                                                 \
+    mock::detail::function<S>& t##_mock_registered() const                                                            \
+    {                                                                                                                 \
+        if(!t##_mock_.registered())                                                                                   \
+            t##_mock(mock::detail::root, "?.");                                                                       \
+        return t##_mock_;                                                                                             \
     }
 
 #define MOCK_PARAM(S) mock::detail::parameter_t < S
@@ -58,7 +73,7 @@ namespace mock { namespace detail {
 #define MOCK_FORWARD_PARAMS(n, S) BOOST_PP_REPEAT(n, MOCK_FORWARD_PARAM, std::forward < MOCK_PARAM(S))
 #define MOCK_METHOD_AUX(M, n, S, t, c)                                              \
     static_assert(n == mock::detail::function_arity_t<S>::value, "Arity mismatch"); \
-    MOCK_DECL(M, n, S, c) { return MOCK_ANONYMOUS_HELPER(t)(MOCK_FORWARD_PARAMS(n, S)); }
+    MOCK_DECL(M, n, S, c) { return MOCK_ANONYMOUS_HELPER(t).forward(MOCK_FORWARD_PARAMS(n, S)); }
 
 #define MOCK_METHOD_EXT(M, n, S, t)    \
     MOCK_METHOD_AUX(M, n, S, t, )      \
@@ -71,21 +86,27 @@ namespace mock { namespace detail {
     MOCK_METHOD_AUX(M, n, S, t, )             \
     MOCK_METHOD_HELPER(S, t)
 
+#define MOCK_STATIC_HELPER(t) mock::detail::register_once(t##_mock_static(), BOOST_PP_STRINGIZE(t))
+
 #define MOCK_FUNCTION_HELPER(S, t, s)                                                                              \
-    s mock::detail::function<S>& t##_mock(mock::detail::context& context, boost::unit_test::const_string instance) \
+    s mock::detail::function<S>& t##_mock_static()                                                                 \
     {                                                                                                              \
         static mock::detail::function<S> f;                                                                        \
-        return f(context, instance);                                                                               \
+        return f;                                                                                                  \
+    }                                                                                                              \
+    s mock::detail::function<S>& t##_mock(mock::detail::context& context, boost::unit_test::const_string instance) \
+    {                                                                                                              \
+        return t##_mock_static()(context, instance);                                                               \
     }
 
-#define MOCK_CONSTRUCTOR_AUX(T, n, A, t)                                               \
-    T(MOCK_DECL_PARAMS(n, void A)) { MOCK_HELPER(t)(MOCK_FORWARD_PARAMS(n, void A)); } \
+#define MOCK_CONSTRUCTOR_AUX(T, n, A, t)                                                              \
+    T(MOCK_DECL_PARAMS(n, void A)) { MOCK_STATIC_HELPER(t).forward(MOCK_FORWARD_PARAMS(n, void A)); } \
     MOCK_FUNCTION_HELPER(void A, t, static)
 
 #define MOCK_FUNCTION_AUX(F, n, S, t, s)                                            \
     MOCK_FUNCTION_HELPER(S, t, s)                                                   \
     static_assert(n == mock::detail::function_arity_t<S>::value, "Arity mismatch"); \
-    s MOCK_DECL(F, n, S, ) { return MOCK_HELPER(t)(MOCK_FORWARD_PARAMS(n, S)); }
+    s MOCK_DECL(F, n, S, ) { return MOCK_STATIC_HELPER(t).forward(MOCK_FORWARD_PARAMS(n, S)); }
 
 #define MOCK_VARIADIC_ELEM_0(e0, ...) e0
 #define MOCK_VARIADIC_ELEM_1(e0, e1, ...) e1
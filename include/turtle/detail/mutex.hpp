@@ -10,89 +10,401 @@
 #define MOCK_MUTEX_HPP_INCLUDED
 
 #include "../config.hpp"
+#include "../mutex_policy.hpp"
 #include "singleton.hpp"
+#include <boost/test/utils/lazy_ostream.hpp>
+#include <cstddef>
 #include <memory>
+#include <ostream>
 
 #ifdef MOCK_THREAD_SAFE
 
+#    include <boost/assert.hpp>
+#    include <algorithm>
+#    include <atomic>
+#    include <limits>
+#    include <vector>
 #    ifdef MOCK_HDR_MUTEX
 #        include <mutex>
 #    else
-#        include <boost/thread/lock_guard.hpp>
 #        include <boost/thread/recursive_mutex.hpp>
 #    endif
+#    if defined(MOCK_HDR_MUTEX) && defined(MOCK_HDR_SHARED_MUTEX)
+#        include <shared_mutex>
+#    else
+#        include <boost/thread/shared_mutex.hpp>
+#    endif
 
 namespace mock { namespace detail {
-#    ifdef MOCK_HDR_MUTEX
-    typedef std::recursive_mutex mutex;
-    typedef std::lock_guard<mutex> scoped_lock;
+    /// Mutex which can be locked either exclusively or shared amongst several threads
+    /// The underlying mutex is not recursive: the exclusive owner and the shared holders of the current thread are
+    /// tracked so that a thread can lock it again in any mode without blocking. Locking it exclusively while only
+    /// holding it shared gives up the shared ownership until the exclusive one is released, hence anything read
+    /// under the shared ownership must be checked again once locked exclusively.
+    /// It must be unlocked by the thread which locked it.
+    class shared_mutex
+    {
+    public:
+        /// Shared ownership of the current thread, stacked by the shared locks
+        struct holder
+        {
+            const shared_mutex* m;
+            holder* next;
+        };
+
+        shared_mutex() : owner_(nullptr), exclusive_(0) {}
+        shared_mutex(const shared_mutex&) = delete;
+        shared_mutex& operator=(const shared_mutex&) = delete;
+
+        void lock()
+        {
+            const void* self = current_thread();
+            if(owner_.load(std::memory_order_relaxed) == self)
+            {
+                ++exclusive_;
+                return;
+            }
+            if(held_shared())
+                m_.unlock_shared();
+            m_.lock();
+            owner_.store(self, std::memory_order_relaxed);
+            exclusive_ = 1;
+        }
+        void unlock()
+        {
+            BOOST_ASSERT(owner_.load(std::memory_order_relaxed) == current_thread());
+            if(--exclusive_ > 0)
+                return;
+            owner_.store(nullptr, std::memory_order_relaxed);
+            m_.unlock();
+            if(held_shared())
+                m_.lock_shared();
+        }
+        /// `h` must be released by unlock_shared in reverse order of locking
+        void lock_shared(holder& h)
+        {
+            if(owner_.load(std::memory_order_relaxed) != current_thread() && !held_shared())
+                m_.lock_shared();
+            h.m = this;
+            h.next = top();
+            top() = &h;
+        }
+        void unlock_shared(holder& h)
+        {
+            BOOST_ASSERT(top() == &h);
+            top() = h.next;
+            if(owner_.load(std::memory_order_relaxed) != current_thread() && !held_shared())
+                m_.unlock_shared();
+        }
+
+    private:
+        /// Unique address per thread
+        static const void* current_thread()
+        {
+            static thread_local const char tag = 0;
+            return &tag;
+        }
+        /// Last shared ownership taken by the current thread, only ever a few deep
+        static holder*& top()
+        {
+            static thread_local holder* top = nullptr;
+            return top;
+        }
+        bool held_shared() const
+        {
+            for(const holder* h = top(); h; h = h->next)
+                if(h->m == this)
+                    return true;
+            return false;
+        }
+
+        std::atomic<const void*> owner_;
+        /// Only accessed by the owner
+        std::size_t exclusive_;
+#    if defined(MOCK_HDR_MUTEX) && defined(MOCK_HDR_SHARED_MUTEX)
+        std::shared_timed_mutex m_;
 #    else
-    typedef boost::recursive_mutex mutex;
-    typedef boost::lock_guard<mutex> scoped_lock;
+        boost::shared_mutex m_;
 #    endif
+    };
 
-    struct lock
+    /// Counter which can be incremented concurrently up to a maximum
+    class bounded_counter
     {
     public:
-        lock(const std::shared_ptr<mutex>& m) : m_(m) { m_->lock(); }
-        ~lock()
+        bounded_counter() : count_(0) {}
+        bounded_counter(const bounded_counter& c) : count_(c.get()) {}
+        bounded_counter& operator=(const bounded_counter& c)
         {
-            if(m_)
-                m_->unlock();
+            count_.store(c.get(), std::memory_order_relaxed);
+            return *this;
+        }
+
+        std::size_t get() const { return count_.load(std::memory_order_relaxed); }
+
+        /// Returns false without incrementing if the count has reached `max`
+        bool increment(std::size_t max)
+        {
+            // Unbounded counts cannot realistically overflow and do not need to compare first
+            if(max == (std::numeric_limits<std::size_t>::max)())
+            {
+                count_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            std::size_t count = get();
+            do
+            {
+                if(count >= max)
+                    return false;
+            } while(!count_.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+            return true;
         }
-        lock(const lock&) = delete;
-        lock(lock&& x) = default;
-        lock& operator=(const lock&) = delete;
-        lock& operator=(lock&& x) = default;
 
     private:
-        std::shared_ptr<mutex> m_;
+        std::atomic<std::size_t> count_;
     };
 }} // namespace mock::detail
 
 #else // MOCK_THREAD_SAFE
 
 namespace mock { namespace detail {
-    struct mutex
+    struct shared_mutex
     {
-        mutex() = default;
-        mutex(const mutex&) = delete;
-        mutex& operator=(const mutex&) = delete;
+        struct holder
+        {};
+
+        shared_mutex() = default;
+        shared_mutex(const shared_mutex&) = delete;
+        shared_mutex& operator=(const shared_mutex&) = delete;
 
         void lock() {}
         void unlock() {}
+        void lock_shared(holder&) {}
+        void unlock_shared(holder&) {}
     };
-    // Dummy lock classes.
-    // Constructor + Destructor make it RAII classes for compilers and avoid unused variable warnings
-    struct scoped_lock
+    class bounded_counter
+    {
+    public:
+        bounded_counter() : count_(0) {}
+
+        std::size_t get() const { return count_; }
+
+        bool increment(std::size_t max)
+        {
+            if(count_ >= max)
+                return false;
+            ++count_;
+            return true;
+        }
+
+    private:
+        std::size_t count_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_THREAD_SAFE
+
+namespace mock { namespace detail {
+    /// Reentrant mutex guarding objects, sequences and error reporting, see MOCK_MUTEX_POLICY
+    typedef MOCK_MUTEX_POLICY mutex;
+
+    /// Ownership of a mutex for the duration of a scope
+    class scoped_lock
     {
+    public:
+        explicit scoped_lock(mutex& m) : m_(m) { m_.lock(); }
+        ~scoped_lock() { m_.unlock(); }
         scoped_lock(const scoped_lock&) = delete;
         scoped_lock& operator=(const scoped_lock&) = delete;
 
-        scoped_lock(mutex&) {}
-        ~scoped_lock() {}
+    private:
+        mutex& m_;
     };
+
+    /// Exclusive ownership of a shared_mutex for the duration of a scope
+    class exclusive_lock
+    {
+    public:
+        explicit exclusive_lock(shared_mutex& m) : m_(m) { m_.lock(); }
+        ~exclusive_lock() { m_.unlock(); }
+        exclusive_lock(const exclusive_lock&) = delete;
+        exclusive_lock& operator=(const exclusive_lock&) = delete;
+
+    private:
+        shared_mutex& m_;
+    };
+
+    /// Shared ownership of a shared_mutex for the duration of a scope
+    class shared_lock
+    {
+    public:
+        explicit shared_lock(shared_mutex& m) : m_(m) { m_.lock_shared(h_); }
+        ~shared_lock() { m_.unlock_shared(h_); }
+        shared_lock(const shared_lock&) = delete;
+        shared_lock& operator=(const shared_lock&) = delete;
+
+    private:
+        shared_mutex& m_;
+        shared_mutex::holder h_;
+    };
+
+    /// Movable exclusive ownership of a shared_mutex, keeping it alive
+    /// Only needed by objects which may outlive the owner of the mutex, the scoped locks merely borrow it.
+    /// It may be moved around but must be released by the thread which created it.
     class lock
     {
     public:
-        lock(const std::shared_ptr<mutex>&) {}
-        ~lock() {}
+        lock(const std::shared_ptr<shared_mutex>& m) : m_(m) { m_->lock(); }
+        ~lock()
+        {
+            if(m_)
+                m_->unlock();
+        }
         lock(const lock&) = delete;
-        lock(lock&&) = default;
+        lock(lock&& x) = default;
         lock& operator=(const lock&) = delete;
-        lock& operator=(lock&&) = default;
-    };
-}} // namespace mock::detail
+        lock& operator=(lock&& x) = default;
 
-#endif // MOCK_THREAD_SAFE
+    private:
+        std::shared_ptr<shared_mutex> m_;
+    };
 
-namespace mock { namespace detail {
     class error_mutex_t : public singleton<error_mutex_t>, public mutex
     {
         MOCK_SINGLETON_CONS(error_mutex_t);
     };
     MOCK_SINGLETON_INST(error_mutex)
 
+#ifdef MOCK_THREAD_SAFE
+    /// Successful calls made by a thread, reported to the error policy in batches
+    /// Formatting the context of each call would cost more than the lock it saves, hence only the source of the
+    /// call, formatted lazily when reporting it, and the location of the expectation are kept. Consecutive calls
+    /// to the same expectation are merged.
+    class call_buffer
+    {
+    public:
+        typedef void (*report_type)(const void* source, const char* file, int line);
+
+        call_buffer();
+        ~call_buffer();
+        call_buffer(const call_buffer&) = delete;
+        call_buffer& operator=(const call_buffer&) = delete;
+
+        /// Buffer of the current thread
+        static call_buffer& local()
+        {
+            static thread_local call_buffer buffer;
+            return buffer;
+        }
+
+        void push(report_type report, const void* source, const char* file, int line)
+        {
+            bool full;
+            {
+                scoped_lock _(mutex_);
+                if(!records_.empty() && records_.back().report == report && records_.back().source == source &&
+                   records_.back().file == file && records_.back().line == line)
+                    ++records_.back().count;
+                else
+                    records_.push_back(record{ report, source, file, line, 1 });
+                full = records_.size() >= capacity;
+            }
+            if(full)
+                flush();
+        }
+        void flush()
+        {
+            scoped_lock _(error_mutex);
+            flush_locked();
+        }
+        /// Must be called with the error mutex locked
+        void flush_locked()
+        {
+            std::vector<record> records;
+            {
+                scoped_lock _(mutex_);
+                records.swap(records_);
+            }
+            for(const record& r : records)
+                for(std::size_t i = 0; i < r.count; ++i)
+                    r.report(r.source, r.file, r.line);
+        }
+
+    private:
+        static constexpr std::size_t capacity = 1024;
+
+        struct record
+        {
+            report_type report;
+            const void* source;
+            const char* file;
+            int line;
+            std::size_t count;
+        };
+        std::vector<record> records_;
+        /// Only contended when another thread flushes all buffers
+        mutex mutex_;
+    };
+
+    /// Registry of the call buffers of all threads
+    class call_buffers_t : public singleton<call_buffers_t>
+    {
+    public:
+        void add(call_buffer& b)
+        {
+            scoped_lock _(mutex_);
+            buffers_.push_back(&b);
+        }
+        void remove(call_buffer& b)
+        {
+            scoped_lock _(mutex_);
+            buffers_.erase(std::find(buffers_.begin(), buffers_.end(), &b));
+        }
+        void flush()
+        {
+            scoped_lock _(mutex_);
+            scoped_lock reporting(error_mutex);
+            for(call_buffer* b : buffers_)
+                b->flush_locked();
+        }
+
+        /// Returns true for the thread which created the registry, normally the one running the tests
+        /// Its calls are reported right away, as without thread safety, and therefore still lock the error mutex.
+        static bool& reports_directly()
+        {
+            static thread_local bool direct = false;
+            return direct;
+        }
+
+    private:
+        friend class singleton<call_buffers_t>;
+        call_buffers_t() { reports_directly() = true; }
+
+        std::vector<call_buffer*> buffers_;
+        mutex mutex_;
+    };
+    MOCK_SINGLETON_INST(call_buffers)
+
+    inline call_buffer::call_buffer()
+    {
+        call_buffers.add(*this);
+    }
+    inline call_buffer::~call_buffer()
+    {
+        flush();
+        call_buffers.remove(*this);
+    }
+#endif // MOCK_THREAD_SAFE
+
+    /// Reports the calls buffered by all threads to the error policy
+    /// Must be called before destroying the source of any of these calls.
+    inline void flush_calls()
+    {
+#ifdef MOCK_THREAD_SAFE
+        call_buffers.flush();
+#endif
+    }
+
 #ifdef BOOST_MSVC
 #    pragma warning(push)
 #    pragma warning(disable : 4702)
@@ -111,12 +423,29 @@ namespace mock { namespace detail {
                          const char* file = "unknown location",
                          int line = 0)
         {
+            flush_calls();
             scoped_lock _(error_mutex);
             Error::fail(message, context, file, line);
         }
         template<typename Context>
         static void call(const Context& context, const char* file, int line)
         {
+            call<unknown_source>(context, nullptr, file, line);
+        }
+        /// Calls buffered from another thread are reported with `Buffered(source)` as context
+        template<typename Buffered, typename Context>
+        static void call(const Context& context, const void* source, const char* file, int line)
+        {
+#ifdef MOCK_THREAD_SAFE
+            // Keeps concurrent calls from contending on the error mutex
+            if(!call_buffers_t::reports_directly())
+            {
+                call_buffer::local().push(&report<Buffered>, source, file, line);
+                return;
+            }
+#else
+            (void)source;
+#endif
             scoped_lock _(error_mutex);
             Error::call(context, file, line);
         }
@@ -125,6 +454,22 @@ namespace mock { namespace detail {
             scoped_lock _(error_mutex);
             Error::pass(file, line);
         }
+
+    private:
+        struct unknown_source
+        {
+            explicit unknown_source(const void*) {}
+            friend std::ostream& operator<<(std::ostream& s, const unknown_source&)
+            {
+                return s << "? (buffered call from another thread)";
+            }
+        };
+
+        template<typename Buffered>
+        static void report(const void* source, const char* file, int line)
+        {
+            Error::call(boost::unit_test::lazy_ostream::instance() << Buffered(source), file, line);
+        }
     };
 #ifdef BOOST_MSVC
 #    pragma warning(pop)
@@ -23,27 +23,25 @@ namespace mock { namespace detail {
     class object_impl : public context, public verifiable, public std::enable_shared_from_this<object_impl>
     {
     public:
-        object_impl() : mutex_(std::make_shared<mutex>()) {}
-
         virtual void add(const void* /*p*/,
                          verifiable& v,
                          boost::unit_test::const_string instance,
                          boost::optional<type_name> type,
                          boost::unit_test::const_string name)
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             if(children_.empty())
                 detail::root.add(*this);
             children_[&v].update(parent_, instance, type, name);
         }
         virtual void add(verifiable& v)
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             group_.add(v);
         }
         virtual void remove(verifiable& v)
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             group_.remove(v);
             children_.erase(&v);
             if(children_.empty())
@@ -52,7 +50,7 @@ namespace mock { namespace detail {
 
         virtual void serialize(std::ostream& s, const verifiable& v) const
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             const auto it = children_.find(&v);
             if(it != children_.end())
                 s << it->second;
@@ -62,21 +60,26 @@ namespace mock { namespace detail {
 
         virtual bool verify() const
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             return group_.verify();
         }
         virtual void reset()
         {
-            lock _(mutex_);
             std::shared_ptr<object_impl> guard = shared_from_this();
+            scoped_lock _(mutex_);
             group_.reset();
         }
+        virtual void freeze()
+        {
+            scoped_lock _(mutex_);
+            group_.freeze();
+        }
 
     private:
         group group_;
         parent parent_;
         std::map<const verifiable*, child> children_;
-        const std::shared_ptr<mutex> mutex_;
+        mutable mutex mutex_;
     };
 }} // namespace mock::detail
 
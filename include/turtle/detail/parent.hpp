@@ -20,12 +20,19 @@ namespace mock { namespace detail {
     {
     public:
         parent() = default;
-        parent(boost::unit_test::const_string instance, boost::optional<type_name> type)
-            : instance_(instance), type_(type)
+        /// `instance` is the expression the mocked method `name` was accessed through, e.g. "obj.method",
+        /// only the part before `name` gets printed
+        parent(boost::unit_test::const_string instance,
+               boost::optional<type_name> type,
+               boost::unit_test::const_string name = "")
+            : instance_(instance), name_(name), type_(type)
         {}
         friend std::ostream& operator<<(std::ostream& s, const parent& p)
         {
-            s << p.instance_;
+            if(p.name_.is_empty())
+                s << p.instance_;
+            else
+                s << p.instance_.substr(0, p.instance_.rfind(p.name_));
             if(p.type_)
                 s << *p.type_ << "::";
             return s;
@@ -33,6 +40,7 @@ namespace mock { namespace detail {
 
     private:
         boost::unit_test::const_string instance_;
+        boost::unit_test::const_string name_;
         boost::optional<type_name> type_;
     };
 }} // namespace mock::detail
@@ -0,0 +1,68 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_RANGE_SCAN_HPP_INCLUDED
+#define MOCK_RANGE_SCAN_HPP_INCLUDED
+
+#include "../config.hpp"
+#include <cstddef>
+#if defined(MOCK_AVX)
+#    include <immintrin.h>
+#elif defined(MOCK_SSE2)
+#    include <emmintrin.h>
+#endif
+
+namespace mock { namespace detail {
+    inline std::size_t lowest_bit(int mask)
+    {
+        std::size_t i = 0;
+        while(!(mask & 1))
+        {
+            mask >>= 1;
+            ++i;
+        }
+        return i;
+    }
+
+    /// Returns the first position from `first` such that `lower[i] <= value && value <= upper[i]`, or `size`
+    /// Checks 4 (AVX) or 2 (SSE2) bounds at a time when available, a NaN value is within no bounds.
+    inline std::size_t
+    scan_ranges(const double* lower, const double* upper, std::size_t first, std::size_t size, double value)
+    {
+        std::size_t i = first;
+#if defined(MOCK_AVX)
+        const __m256d v = _mm256_set1_pd(value);
+        for(; i + 4 <= size; i += 4)
+        {
+            const __m256d above = _mm256_cmp_pd(_mm256_loadu_pd(lower + i), v, _CMP_LE_OQ);
+            const __m256d below = _mm256_cmp_pd(v, _mm256_loadu_pd(upper + i), _CMP_LE_OQ);
+            const int mask = _mm256_movemask_pd(_mm256_and_pd(above, below));
+            if(mask)
+                return i + lowest_bit(mask);
+        }
+#elif defined(MOCK_SSE2)
+        const __m128d v = _mm_set1_pd(value);
+        for(; i + 2 <= size; i += 2)
+        {
+            const __m128d above = _mm_cmple_pd(_mm_loadu_pd(lower + i), v);
+            const __m128d below = _mm_cmple_pd(v, _mm_loadu_pd(upper + i));
+            const int mask = _mm_movemask_pd(_mm_and_pd(above, below));
+            if(mask)
+                return i + lowest_bit(mask);
+        }
+#endif
+        for(; i < size; ++i)
+        {
+            if(lower[i] <= value && value <= upper[i])
+                return i;
+        }
+        return size;
+    }
+}} // namespace mock::detail
+
+#endif // MOCK_RANGE_SCAN_HPP_INCLUDED
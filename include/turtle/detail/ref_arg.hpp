@@ -9,6 +9,7 @@
 #ifndef MOCK_REF_ARG_HPP_INCLUDED
 #define MOCK_REF_ARG_HPP_INCLUDED
 
+#include "../config.hpp"
 #include <type_traits>
 
 namespace mock { namespace detail {
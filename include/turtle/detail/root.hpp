@@ -51,14 +51,21 @@ namespace mock { namespace detail {
 
         bool verify() const
         {
+            flush_calls();
             scoped_lock _(mutex_);
             return group_.verify();
         }
         void reset()
         {
+            flush_calls();
             scoped_lock _(mutex_);
             group_.reset();
         }
+        void freeze()
+        {
+            scoped_lock _(mutex_);
+            group_.freeze();
+        }
 
         virtual void serialize(std::ostream& s, const verifiable& v) const
         {
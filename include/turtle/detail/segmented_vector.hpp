@@ -0,0 +1,150 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_SEGMENTED_VECTOR_HPP_INCLUDED
+#define MOCK_SEGMENTED_VECTOR_HPP_INCLUDED
+
+#include "../config.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mock { namespace detail {
+    /// Sequence of elements stored contiguously in segments of doubling capacity.
+    /// Elements are constructed in place and never relocated, so their addresses remain valid
+    /// until the container is cleared, even for non-movable types.
+    template<typename T>
+    class segmented_vector
+    {
+        typedef std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        struct segment
+        {
+            std::unique_ptr<storage[]> data;
+            std::size_t size, capacity;
+
+            T* begin() const { return reinterpret_cast<T*>(data.get()); }
+        };
+
+        template<typename U>
+        class iterator_base
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::remove_const_t<U> value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef U* pointer;
+            typedef U& reference;
+
+            iterator_base() : segment_(nullptr), last_(nullptr), element_(nullptr) {}
+            iterator_base(const segment* first, const segment* last)
+                : segment_(first), last_(last), element_(first->begin())
+            {}
+            template<typename V, typename = std::enable_if_t<std::is_convertible<V*, U*>::value>>
+            iterator_base(const iterator_base<V>& it) : segment_(it.segment_), last_(it.last_), element_(it.element_)
+            {}
+
+            reference operator*() const { return *element_; }
+            pointer operator->() const { return element_; }
+            iterator_base& operator++()
+            {
+                if(++element_ == segment_->begin() + segment_->size)
+                    element_ = ++segment_ == last_ ? nullptr : segment_->begin();
+                return *this;
+            }
+            iterator_base operator++(int)
+            {
+                iterator_base it = *this;
+                ++*this;
+                return it;
+            }
+            friend bool operator==(const iterator_base& lhs, const iterator_base& rhs)
+            {
+                return lhs.element_ == rhs.element_;
+            }
+            friend bool operator!=(const iterator_base& lhs, const iterator_base& rhs) { return !(lhs == rhs); }
+
+        private:
+            template<typename V>
+            friend class iterator_base;
+
+            const segment* segment_;
+            const segment* last_;
+            U* element_;
+        };
+
+    public:
+        typedef T value_type;
+        typedef iterator_base<T> iterator;
+        typedef iterator_base<const T> const_iterator;
+
+        segmented_vector() : size_(0) {}
+        segmented_vector(const segmented_vector&) = delete;
+        segmented_vector& operator=(const segmented_vector&) = delete;
+        ~segmented_vector() { clear(); }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            if(segments_.empty() || segments_.back().size == segments_.back().capacity)
+                grow();
+            segment& s = segments_.back();
+            T* t = new(s.begin() + s.size) T(std::forward<Args>(args)...);
+            ++s.size;
+            ++size_;
+            return *t;
+        }
+
+        /// Destroys all elements but keeps the storage of the first segment
+        void clear()
+        {
+            for(segment& s : segments_)
+            {
+                for(T* t = s.begin(); t != s.begin() + s.size; ++t)
+                    t->~T();
+                s.size = 0;
+            }
+            if(segments_.size() > 1)
+                segments_.erase(segments_.begin() + 1, segments_.end());
+            size_ = 0;
+        }
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        T& back() { return *(segments_.back().begin() + segments_.back().size - 1); }
+        const T& back() const { return *(segments_.back().begin() + segments_.back().size - 1); }
+
+        iterator begin() { return empty() ? end() : iterator(segments_.data(), last()); }
+        iterator end() { return iterator(); }
+        const_iterator begin() const { return empty() ? end() : const_iterator(segments_.data(), last()); }
+        const_iterator end() const { return const_iterator(); }
+
+    private:
+        /// Past the end of the segments holding elements, only the last segment can be empty
+        const segment* last() const
+        {
+            return segments_.data() + segments_.size() - (segments_.back().size == 0 ? 1 : 0);
+        }
+
+        void grow()
+        {
+            const std::size_t capacity = segments_.empty() ? 1 : segments_.back().capacity * 2;
+            segments_.push_back(segment{ std::unique_ptr<storage[]>(new storage[capacity]), 0, capacity });
+        }
+
+        std::vector<segment> segments_;
+        std::size_t size_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_SEGMENTED_VECTOR_HPP_INCLUDED
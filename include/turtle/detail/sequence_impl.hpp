@@ -12,35 +12,32 @@
 #include "../config.hpp"
 #include "mutex.hpp"
 #include <algorithm>
-#include <memory>
 #include <vector>
 
 namespace mock { namespace detail {
     class sequence_impl
     {
     public:
-        sequence_impl() : mutex_(std::make_shared<mutex>()) {}
-
         void add(void* e)
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             elements_.push_back(e);
         }
         void remove(void* e)
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             elements_.erase(std::remove(elements_.begin(), elements_.end(), e), elements_.end());
         }
 
         bool is_valid(const void* e) const
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             return std::find(elements_.begin(), elements_.end(), e) != elements_.end();
         }
 
         void invalidate(const void* e)
         {
-            lock _(mutex_);
+            scoped_lock _(mutex_);
             const auto it = std::find(elements_.begin(), elements_.end(), e);
             if(it != elements_.end())
                 elements_.erase(elements_.begin(), it);
@@ -48,7 +45,7 @@ namespace mock { namespace detail {
 
     private:
         std::vector<void*> elements_;
-        const std::shared_ptr<mutex> mutex_;
+        mutable mutex mutex_;
     };
 }} // namespace mock::detail
 
@@ -9,6 +9,7 @@
 #ifndef MOCK_SINGLETON_HPP
 #define MOCK_SINGLETON_HPP
 
+#include "../config.hpp"
 #include <boost/config.hpp>
 
 namespace mock { namespace detail {
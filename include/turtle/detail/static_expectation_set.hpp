@@ -0,0 +1,302 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_STATIC_EXPECTATION_SET_HPP_INCLUDED
+#define MOCK_STATIC_EXPECTATION_SET_HPP_INCLUDED
+
+#include "../config.hpp"
+#include "../unwrap_reference.hpp"
+#include "function_impl.hpp"
+#include "invocation.hpp"
+#include "matcher_tuple.hpp"
+#include "mutex.hpp"
+#include "ref_arg.hpp"
+#include <boost/test/utils/lazy_ostream.hpp>
+#include <cstddef>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mock { namespace detail {
+    struct no_action
+    {};
+    template<typename T>
+    struct value_action
+    {
+        T value_;
+    };
+    template<typename F>
+    struct call_action
+    {
+        F f_;
+    };
+    template<typename E>
+    struct throw_action
+    {
+        E e_;
+    };
+
+    /// Expectation whose constraints and action are known at compile time
+    template<typename Action, typename... Constraints>
+    class static_expectation
+    {
+    public:
+        static_expectation(const invocation& i, const std::tuple<Constraints...>& c, const Action& a)
+            : invocation_(i), constraints_(c), action_(a)
+        {}
+
+        static_expectation once() const { return static_expectation(detail::once(), constraints_, action_); }
+        static_expectation never() const { return static_expectation(detail::never(), constraints_, action_); }
+        static_expectation exactly(std::size_t count) const
+        {
+            return static_expectation(detail::exactly(count), constraints_, action_);
+        }
+        static_expectation at_least(std::size_t min) const
+        {
+            return static_expectation(detail::at_least(min), constraints_, action_);
+        }
+        static_expectation at_most(std::size_t max) const
+        {
+            return static_expectation(detail::at_most(max), constraints_, action_);
+        }
+        static_expectation between(std::size_t min, std::size_t max) const
+        {
+            return static_expectation(detail::between(min, max), constraints_, action_);
+        }
+
+        template<typename T>
+        static_expectation<value_action<std::decay_t<T>>, Constraints...> returns(T&& t) const
+        {
+            return { invocation_, constraints_, value_action<std::decay_t<T>>{ std::forward<T>(t) } };
+        }
+        template<typename F>
+        static_expectation<call_action<std::decay_t<F>>, Constraints...> calls(F&& f) const
+        {
+            return { invocation_, constraints_, call_action<std::decay_t<F>>{ std::forward<F>(f) } };
+        }
+        template<typename E>
+        static_expectation<throw_action<E>, Constraints...> throws(E e) const
+        {
+            return { invocation_, constraints_, throw_action<E>{ e } };
+        }
+
+        invocation invocation_;
+        std::tuple<Constraints...> constraints_;
+        Action action_;
+    };
+
+    /// Matches any arguments
+    template<typename... Args>
+    struct match_all
+    {
+        bool operator()(ref_arg_t<Args>...) const { return true; }
+        friend std::ostream& operator<<(std::ostream& s, const match_all&)
+        {
+            for(std::size_t i = 0; i < sizeof...(Args); ++i)
+                s << (i ? ", any" : "any");
+            return s;
+        }
+    };
+
+    template<typename Signature, typename Expectation>
+    class static_entry;
+
+    /// Expectation bound to the signature of the function it has been set for
+    template<typename R, typename... Args, typename Action, typename... Constraints>
+    class static_entry<R(Args...), static_expectation<Action, Constraints...>>
+    {
+        static_assert(sizeof...(Constraints) == 0 || sizeof...(Constraints) == sizeof...(Args),
+                      "Need either no constraint or exactly 1 constraint per argument");
+
+        typedef std::conditional_t<sizeof...(Constraints) == 0,
+                                   match_all<Args...>,
+                                   matcher_tuple<void(Constraints...), Args...>>
+          matcher_type;
+
+    public:
+        explicit static_entry(const static_expectation<Action, Constraints...>& e)
+            : invocation_(e.invocation_),
+              matcher_(make_matcher(e.constraints_, std::index_sequence_for<Constraints...>())), action_(e.action_)
+        {}
+
+        bool is_valid(ref_arg_t<Args>... t)
+        {
+            return !invocation_.exhausted() && matcher_(static_cast<ref_arg_t<Args>>(t)...);
+        }
+        bool invoke() { return invocation_.invoke(); }
+        bool verify() const { return invocation_.verify(); }
+
+        static constexpr bool valid() { return std::is_void<R>::value || !std::is_same<Action, no_action>::value; }
+
+        R trigger(ref_arg_t<Args>... t) { return perform(action_, static_cast<ref_arg_t<Args>>(t)...); }
+
+        friend std::ostream& operator<<(std::ostream& s, const static_entry& e)
+        {
+            s << (e.invocation_.exhausted() ? 'v' : '.') << ' ' << e.invocation_;
+            if(sizeof...(Args) > 0)
+                s << ".with( " << e.matcher_ << " )";
+            return s;
+        }
+
+    private:
+        template<std::size_t... I>
+        static matcher_type make_matcher(const std::tuple<Constraints...>& c, std::index_sequence<I...>)
+        {
+            return matcher_type(std::get<I>(c)...);
+        }
+
+        static R perform(no_action&, ref_arg_t<Args>...) { return nothing(std::is_void<R>()); }
+        static void nothing(std::true_type) {}
+        static R nothing(std::false_type) { return safe_error<R, MOCK_ERROR_POLICY<R>>::abort(); }
+        template<typename T>
+        static R perform(value_action<T>& a, ref_arg_t<Args>...)
+        {
+            return unwrap_ref(a.value_);
+        }
+        template<typename F>
+        static R perform(call_action<F>& a, ref_arg_t<Args>... t)
+        {
+            return a.f_(static_cast<ref_arg_t<Args>>(t)...);
+        }
+        template<typename E>
+        static R perform(throw_action<E>& a, ref_arg_t<Args>...)
+        {
+            throw a.e_;
+        }
+
+        invocation invocation_;
+        matcher_type matcher_;
+        Action action_;
+    };
+
+    template<typename Signature, typename... Expectations>
+    class static_expectation_set;
+
+    /// Set of expectations whose types are all known at compile time
+    /// A call tries each expectation in turn without going through any virtual function, allowing the
+    /// compiler to inline the whole selection.
+    template<typename R, typename... Args, typename... Expectations>
+    class static_expectation_set<R(Args...), Expectations...>
+    {
+        typedef safe_error<R, MOCK_ERROR_POLICY<R>> error_type;
+        typedef std::integral_constant<std::size_t, sizeof...(Expectations)> end_type;
+
+    public:
+        explicit static_expectation_set(const Expectations&... e)
+            : entries_(static_entry<R(Args...), Expectations>(e)...), valid_(true), exceptions_(exceptions())
+        {}
+        static_expectation_set(static_expectation_set&& s)
+            : entries_(std::move(s.entries_)), valid_(s.valid_), exceptions_(s.exceptions_)
+        {
+            s.valid_ = false;
+        }
+        static_expectation_set(const static_expectation_set&) = delete;
+        static_expectation_set& operator=(const static_expectation_set&) = delete;
+        ~static_expectation_set()
+        {
+            if(valid_ && exceptions_ >= exceptions())
+                untriggered(std::integral_constant<std::size_t, 0>());
+        }
+
+        bool verify() const
+        {
+            scoped_lock _(mutex_);
+            verify(std::integral_constant<std::size_t, 0>());
+            return valid_;
+        }
+
+        R operator()(Args... args)
+        {
+            scoped_lock _(mutex_);
+            valid_ = false;
+            return dispatch(std::integral_constant<std::size_t, 0>(), static_cast<ref_arg_t<Args>>(args)...);
+        }
+
+        friend std::ostream& operator<<(std::ostream& s, const static_expectation_set& e)
+        {
+            scoped_lock _(e.mutex_);
+            return s << '?' << lazy_entries(&e);
+        }
+
+    private:
+// Due to lifetime rules of references this must be created and consumed in one line
+#define MOCK_STATIC_CONTEXT \
+    boost::unit_test::lazy_ostream::instance() << '?' << lazy_args<Args...>(args...) << lazy_entries(this)
+
+        template<std::size_t I>
+        R dispatch(std::integral_constant<std::size_t, I>, ref_arg_t<Args>... args)
+        {
+            auto& entry = std::get<I>(entries_);
+            if(!entry.is_valid(static_cast<ref_arg_t<Args>>(args)...))
+                return dispatch(std::integral_constant<std::size_t, I + 1>(), static_cast<ref_arg_t<Args>>(args)...);
+            entry.invoke();
+            if(!entry.valid())
+            {
+                error_type::fail("missing action", MOCK_STATIC_CONTEXT);
+                return error_type::abort();
+            }
+            valid_ = true;
+            error_type::call(MOCK_STATIC_CONTEXT, "unknown location", 0);
+            return entry.trigger(static_cast<ref_arg_t<Args>>(args)...);
+        }
+        R dispatch(end_type, ref_arg_t<Args>... args)
+        {
+            error_type::fail("unexpected call", MOCK_STATIC_CONTEXT);
+            return error_type::abort();
+        }
+#undef MOCK_STATIC_CONTEXT
+
+        template<std::size_t I>
+        void verify(std::integral_constant<std::size_t, I>) const
+        {
+            if(!std::get<I>(entries_).verify())
+            {
+                valid_ = false;
+                error_type::fail("verification failed",
+                                 boost::unit_test::lazy_ostream::instance() << '?' << lazy_entries(this));
+            }
+            verify(std::integral_constant<std::size_t, I + 1>());
+        }
+        void verify(end_type) const {}
+
+        template<std::size_t I>
+        void untriggered(std::integral_constant<std::size_t, I>) const
+        {
+            if(!std::get<I>(entries_).verify())
+                error_type::fail("untriggered expectation",
+                                 boost::unit_test::lazy_ostream::instance() << '?' << lazy_entries(this));
+            untriggered(std::integral_constant<std::size_t, I + 1>());
+        }
+        void untriggered(end_type) const {}
+
+        struct lazy_entries
+        {
+            lazy_entries(const static_expectation_set* set) : set_(set) {}
+            friend std::ostream& operator<<(std::ostream& s, const lazy_entries& e)
+            {
+                e.serialize(s, std::index_sequence_for<Expectations...>());
+                return s;
+            }
+            template<std::size_t... I>
+            void serialize(std::ostream& s, std::index_sequence<I...>) const
+            {
+                using expander = int[];
+                (void)expander{ 0, (s << std::endl << std::get<I>(set_->entries_), 0)... };
+            }
+            const static_expectation_set* set_;
+        };
+
+        std::tuple<static_entry<R(Args...), Expectations>...> entries_;
+        mutable bool valid_;
+        const int exceptions_;
+        mutable mutex mutex_;
+    };
+}} // namespace mock::detail
+
+#endif // MOCK_STATIC_EXPECTATION_SET_HPP_INCLUDED
@@ -23,6 +23,8 @@ namespace mock { namespace detail {
         virtual bool verify() const = 0;
 
         virtual void reset() = 0;
+
+        virtual void freeze() = 0;
     };
 }} // namespace mock::detail
 
@@ -9,6 +9,8 @@
 #ifndef MOCK_VOID_T_HPP_INCLUDED
 #define MOCK_VOID_T_HPP_INCLUDED
 
+#include "../config.hpp"
+
 namespace mock { namespace detail {
     template<typename...>
     struct make_void
@@ -0,0 +1,33 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_FREEZE_HPP_INCLUDED
+#define MOCK_FREEZE_HPP_INCLUDED
+
+#include "config.hpp"
+#include "detail/functor.hpp"
+#include "detail/root.hpp"
+#include "object.hpp"
+
+namespace mock {
+inline void freeze()
+{
+    detail::root.freeze();
+}
+inline void freeze(const object& o)
+{
+    o.impl_->freeze();
+}
+template<typename Signature>
+void freeze(detail::functor<Signature>& f)
+{
+    f.freeze();
+}
+} // namespace mock
+
+#endif // MOCK_FREEZE_HPP_INCLUDED
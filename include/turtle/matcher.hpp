@@ -74,6 +74,42 @@ public:
 private:
     Functor c_;
 };
+
+namespace detail {
+    /// Hint on the cost of evaluating a matcher, see constraint_cost
+    template<typename Matcher>
+    struct matcher_cost : std::integral_constant<evaluation_cost, evaluation_cost::expensive>
+    {};
+    template<typename Actual, typename Expected>
+    struct matcher_cost<matcher<Actual, Expected>> :
+        std::integral_constant<evaluation_cost,
+                               is_functor<Expected, Actual>::value ? evaluation_cost::expensive :
+                                                                     evaluation_cost::trivial>
+    {};
+    template<>
+    struct matcher_cost<matcher<const char*, const char*>> :
+        std::integral_constant<evaluation_cost, evaluation_cost::cheap>
+    {};
+    template<typename Actual, typename Constraint>
+    struct matcher_cost<matcher<Actual, mock::constraint<Constraint>>> : constraint_cost<Constraint>
+    {};
+
+    /// Whether a matcher can be evaluated by several calls at once, see stateless_constraint
+    /// Comparing to an expected value is, functors are not known to be.
+    template<typename Matcher>
+    struct matcher_stateless : std::false_type
+    {};
+    template<typename Actual, typename Expected>
+    struct matcher_stateless<matcher<Actual, Expected>> :
+        std::integral_constant<bool, !is_functor<Expected, Actual>::value>
+    {};
+    template<>
+    struct matcher_stateless<matcher<const char*, const char*>> : std::true_type
+    {};
+    template<typename Actual, typename Constraint>
+    struct matcher_stateless<matcher<Actual, mock::constraint<Constraint>>> : stateless_constraint<Constraint>
+    {};
+} // namespace detail
 } // namespace mock
 
 #endif // MOCK_MATCHER_HPP_INCLUDED
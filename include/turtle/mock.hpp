@@ -12,8 +12,10 @@
 #include "cleanup.hpp"
 #include "config.hpp"
 #include "detail/mock_impl.hpp"
+#include "freeze.hpp"
 #include "object.hpp"
 #include "reset.hpp"
+#include "static_expectations.hpp"
 #include "verify.hpp"
 
 /// MOCK_CLASS( name )
@@ -109,6 +111,12 @@
 /// MOCK_RESET( identifier )
 /// Reset all pending expectations for the identifier
 #define MOCK_RESET(identifier) MOCK_HELPER(identifier).reset(__FILE__, __LINE__)
+/// MOCK_INDEX( identifier )
+/// Look up the expectations for the identifier by the value their first argument is expected to be equal to
+#define MOCK_INDEX(identifier) MOCK_HELPER(identifier).index(__FILE__, __LINE__)
+/// MOCK_FREEZE( identifier )
+/// Compile the expectations for the identifier into a read-only dispatch table until the next change
+#define MOCK_FREEZE(identifier) MOCK_HELPER(identifier).freeze(__FILE__, __LINE__)
 /// MOCK_VERIFY( identifier )
 /// Verify all expectations for the identifier have been met
 #define MOCK_VERIFY(identifier) MOCK_HELPER(identifier).verify(__FILE__, __LINE__)
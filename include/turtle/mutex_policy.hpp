@@ -0,0 +1,78 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_MUTEX_POLICY_HPP_INCLUDED
+#define MOCK_MUTEX_POLICY_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace mock {
+/// Mutex policy which does not lock at all, the default without MOCK_THREAD_SAFE
+struct null_mutex
+{
+    null_mutex() = default;
+    null_mutex(const null_mutex&) = delete;
+    null_mutex& operator=(const null_mutex&) = delete;
+
+    void lock() {}
+    void unlock() {}
+};
+
+/// Reentrant mutex policy busy waiting instead of blocking
+/// Cheaper than a system mutex for the short critical sections of the library, as long as there are
+/// not many more threads contending for it than cores.
+class spin_mutex
+{
+public:
+    spin_mutex() : owner_(nullptr), count_(0) {}
+    spin_mutex(const spin_mutex&) = delete;
+    spin_mutex& operator=(const spin_mutex&) = delete;
+
+    void lock()
+    {
+        const void* self = current_thread();
+        if(owner_.load(std::memory_order_relaxed) == self)
+        {
+            ++count_;
+            return;
+        }
+        const void* none = nullptr;
+        while(!owner_.compare_exchange_weak(none, self, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            for(unsigned spins = 0; owner_.load(std::memory_order_relaxed); ++spins)
+            {
+                if(spins >= 64)
+                    std::this_thread::yield();
+            }
+            none = nullptr;
+        }
+        count_ = 1;
+    }
+    void unlock()
+    {
+        if(--count_ == 0)
+            owner_.store(nullptr, std::memory_order_release);
+    }
+
+private:
+    /// Unique address per thread
+    static const void* current_thread()
+    {
+        static thread_local const char tag = 0;
+        return &tag;
+    }
+
+    std::atomic<const void*> owner_;
+    /// Only accessed by the owner
+    std::size_t count_;
+};
+} // namespace mock
+
+#endif // MOCK_MUTEX_POLICY_HPP_INCLUDED
@@ -0,0 +1,37 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_STATIC_EXPECTATIONS_HPP_INCLUDED
+#define MOCK_STATIC_EXPECTATIONS_HPP_INCLUDED
+
+#include "config.hpp"
+#include "detail/static_expectation_set.hpp"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mock {
+/// Begin setting up an expectation for mock::static_expectations
+/// Takes either one constraint per argument or none to accept any arguments.
+template<typename... Constraints>
+detail::static_expectation<detail::no_action, std::decay_t<Constraints>...> static_expect(Constraints&&... c)
+{
+    return { detail::unlimited(),
+             std::tuple<std::decay_t<Constraints>...>(std::forward<Constraints>(c)...),
+             detail::no_action() };
+}
+
+/// Create a callable with the given signature out of a fixed set of expectations
+template<typename Signature, typename... Expectations>
+detail::static_expectation_set<Signature, Expectations...> static_expectations(const Expectations&... e)
+{
+    return detail::static_expectation_set<Signature, Expectations...>(e...);
+}
+} // namespace mock
+
+#endif // MOCK_STATIC_EXPECTATIONS_HPP_INCLUDED
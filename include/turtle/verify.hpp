@@ -21,6 +21,7 @@ inline bool verify()
 }
 inline bool verify(const object& o)
 {
+    detail::flush_calls();
     return o.impl_->verify();
 }
 template<typename Signature>
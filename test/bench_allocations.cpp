@@ -0,0 +1,78 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Counts the heap allocations made and measures the time spent setting up expectations
+
+#include "silent_error.hpp"
+#include <turtle/mock.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+std::size_t allocations = 0;
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if(void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+MOCK_CLASS(mock_class)
+{
+    MOCK_METHOD(method, 1, int(int))
+    MOCK_METHOD(text, 1, std::string(const std::string&))
+};
+
+const int rounds = 1000;
+const int expectations = 100;
+
+/// Prints the average number of allocations and duration per expectation set up
+template<typename F>
+void bench(const char* name, F setup)
+{
+    mock_class m;
+    const std::size_t before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+    {
+        for(int i = 0; i < expectations; ++i)
+            setup(m, i);
+        mock::reset(m);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const double count = static_cast<double>(rounds) * expectations;
+    std::printf("%40s %20.2f %16.1f\n", name, (allocations - before) / count, elapsed.count() / count);
+}
+} // namespace
+
+int main()
+{
+    std::printf("%40s %20s %16s\n", "expectation", "allocations/expect", "ns/expect");
+    bench("with( i ).returns( i )", [](mock_class& m, int i) { MOCK_EXPECT(m.method).with(i).returns(i); });
+    bench("with( less( i ) && greater( 0 ) )", [](mock_class& m, int i) {
+        MOCK_EXPECT(m.method).with(mock::less(i) && mock::greater(0) && mock::less_equal(i)).returns(i);
+    });
+    bench("with( \"text\" ).returns( \"text\" )",
+          [](mock_class& m, int) { MOCK_EXPECT(m.text).with("text").returns(std::string("text")); });
+    return 0;
+}
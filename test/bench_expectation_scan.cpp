@@ -0,0 +1,55 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the cost of scanning through many expectations which do not match a call
+
+#include "silent_error.hpp"
+#include <turtle/mock.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+MOCK_CLASS(mock_class)
+{
+    MOCK_METHOD(method, 1, int(int))
+};
+
+volatile int sink;
+
+/// Average duration of checking an expectation in nanoseconds when calls match the last one declared
+template<typename Setup>
+double bench(int expectations, Setup setup)
+{
+    mock_class m;
+    for(int i = 0; i < expectations; ++i)
+        setup(m, i);
+    const int calls = std::max(10, 10000000 / expectations);
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < calls; ++i)
+        sink = m.method(expectations - 1);
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / calls / expectations;
+}
+} // namespace
+
+int main()
+{
+    std::printf("sizeof(expectation) = %u bytes, durations in ns per expectation scanned\n",
+                static_cast<unsigned>(sizeof(mock::detail::expectation<int(int)>)));
+    std::printf("%12s %24s %24s\n", "expectations", "with( i )", "with( less_equal( i ) )");
+    for(int expectations : { 10, 1000, 100000 })
+    {
+        const double equal =
+          bench(expectations, [](mock_class& m, int i) { MOCK_EXPECT(m.method).with(i).returns(i); });
+        const double less_equal = bench(
+          expectations, [](mock_class& m, int i) { MOCK_EXPECT(m.method).with(mock::less_equal(i)).returns(i); });
+        std::printf("%12d %24.2f %24.2f\n", expectations, equal, less_equal);
+    }
+    return 0;
+}
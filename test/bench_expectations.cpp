@@ -0,0 +1,54 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the cost of selecting an expectation amongst many
+
+#include "silent_error.hpp"
+#include <turtle/mock.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+MOCK_CLASS(mock_class)
+{
+    MOCK_METHOD(method, 1, int(int))
+};
+
+/// Average duration of a call in nanoseconds
+template<typename F>
+double measure(F f, int calls)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < calls; ++i)
+        f();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / calls;
+}
+
+volatile int sink;
+
+void bench(int expectations)
+{
+    mock_class m;
+    for(int i = 0; i < expectations; ++i)
+        MOCK_EXPECT(m.method).with(i).returns(i);
+    const int calls = std::max(100, 1000000 / expectations);
+    const double first = measure([&m]() { sink = m.method(0); }, calls);
+    const double last = measure([&m, expectations]() { sink = m.method(expectations - 1); }, calls);
+    std::printf("%12d %16.1f %16.1f\n", expectations, first, last);
+}
+} // namespace
+
+int main()
+{
+    std::printf("%12s %16s %16s\n", "expectations", "first (ns/call)", "last (ns/call)");
+    for(int expectations : { 1, 10, 100, 10000 })
+        bench(expectations);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the throughput of calls to mocked free functions from several threads
+
+#define MOCK_THREAD_SAFE
+#include "silent_error.hpp"
+#include <turtle/mock.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+// each thread calls its own function so that only the shared registry could serialize them
+MOCK_FUNCTION(function_0, 1, int(int))
+MOCK_FUNCTION(function_1, 1, int(int))
+MOCK_FUNCTION(function_2, 1, int(int))
+MOCK_FUNCTION(function_3, 1, int(int))
+MOCK_FUNCTION(function_4, 1, int(int))
+MOCK_FUNCTION(function_5, 1, int(int))
+MOCK_FUNCTION(function_6, 1, int(int))
+MOCK_FUNCTION(function_7, 1, int(int))
+
+typedef int (*function_type)(int);
+const function_type functions[] = { function_0, function_1, function_2, function_3,
+                                    function_4, function_5, function_6, function_7 };
+
+/// Total number of calls per microsecond
+double measure(unsigned threads, int calls)
+{
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for(unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([t, calls]() {
+            int sink = 0;
+            for(int i = 0; i < calls; ++i)
+                sink += functions[t](i);
+            if(sink < 0)
+                std::abort();
+        });
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * calls / elapsed.count();
+}
+} // namespace
+
+int main()
+{
+    MOCK_EXPECT(function_0).returns(0);
+    MOCK_EXPECT(function_1).returns(1);
+    MOCK_EXPECT(function_2).returns(2);
+    MOCK_EXPECT(function_3).returns(3);
+    MOCK_EXPECT(function_4).returns(4);
+    MOCK_EXPECT(function_5).returns(5);
+    MOCK_EXPECT(function_6).returns(6);
+    MOCK_EXPECT(function_7).returns(7);
+    std::printf("%8s %20s\n", "threads", "calls/us");
+    for(unsigned threads : { 1u, 2u, 4u, 8u })
+        std::printf("%8u %20.1f\n", threads, measure(threads, 200000));
+    mock::reset();
+    return 0;
+}
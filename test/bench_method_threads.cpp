@@ -0,0 +1,57 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Measures the throughput of calls to a single mocked method shared by several threads
+
+#define MOCK_THREAD_SAFE
+#include "silent_error.hpp"
+#include <turtle/mock.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+MOCK_CLASS(mock_class)
+{
+    MOCK_METHOD(method, 1, int(int))
+};
+
+/// Total number of calls per microsecond
+double measure(mock_class& m, unsigned threads, int calls)
+{
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for(unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&m, calls]() {
+            int sink = 0;
+            for(int i = 0; i < calls; ++i)
+                sink += m.method(i % 4);
+            if(sink < 0)
+                std::abort();
+        });
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * calls / elapsed.count();
+}
+} // namespace
+
+int main()
+{
+    mock_class m;
+    for(int i = 0; i < 4; ++i)
+        MOCK_EXPECT(m.method).with(i).returns(i);
+    std::printf("%8s %20s\n", "threads", "calls/us");
+    for(unsigned threads : { 1u, 2u, 4u, 8u })
+        std::printf("%8u %20.1f\n", threads, measure(m, threads, 200000));
+    return 0;
+}
@@ -0,0 +1,68 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares the built-in mutex policies locking for short critical sections from several threads,
+// either each thread with its own mutex or all of them with the same one
+
+#include <turtle/mutex_policy.hpp>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+const int iterations = 200000;
+
+/// Average duration of a lock and unlock pair in nanoseconds
+template<typename Mutex>
+double measure(unsigned threads, bool contended)
+{
+    std::vector<Mutex> mutexes(contended ? 1 : threads);
+    std::vector<long> counters(threads * 16);
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for(unsigned t = 0; t < threads; ++t)
+    {
+        Mutex& m = mutexes[contended ? 0 : t];
+        long& counter = counters[t * 16];
+        workers.emplace_back([&m, &counter]() {
+            for(int i = 0; i < iterations; ++i)
+            {
+                m.lock();
+                ++counter;
+                m.unlock();
+            }
+        });
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(threads) * iterations);
+}
+
+template<typename Mutex>
+void bench(const char* name, bool thread_safe)
+{
+    for(unsigned threads : { 1u, 2u, 4u, 8u })
+    {
+        // Sharing a mutex which does not lock would be a data race
+        const double contended = thread_safe ? measure<Mutex>(threads, true) : 0;
+        std::printf("%22s %8u %16.1f %16.1f\n", name, threads, measure<Mutex>(threads, false), contended);
+    }
+}
+} // namespace
+
+int main()
+{
+    std::printf("%22s %8s %16s %16s\n", "policy", "threads", "own (ns/lock)", "shared (ns/lock)");
+    bench<std::recursive_mutex>("std::recursive_mutex", true);
+    bench<mock::spin_mutex>("mock::spin_mutex", true);
+    bench<mock::null_mutex>("mock::null_mutex", false);
+    return 0;
+}
@@ -0,0 +1,98 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <turtle/detail/action.hpp>
+#include <turtle/detail/arena.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+
+namespace {
+struct alignas(32) over_aligned
+{
+    char data[3];
+};
+
+bool is_aligned(const void* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(default_arena_has_no_chunks)
+{
+    const mock::detail::arena a;
+    BOOST_TEST(a.chunks() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(small_objects_share_a_chunk)
+{
+    mock::detail::arena a;
+    int* i = a.create<int>(1);
+    double* d = a.create<double>(2.);
+    char* c = a.create<char>('c');
+    BOOST_TEST(a.chunks() == 1u);
+    BOOST_TEST(*i == 1);
+    BOOST_TEST(*d == 2.);
+    BOOST_TEST(*c == 'c');
+    BOOST_TEST(is_aligned(d, alignof(double)));
+}
+
+BOOST_AUTO_TEST_CASE(allocations_are_aligned)
+{
+    mock::detail::arena a;
+    a.create<char>('c');
+    BOOST_TEST(is_aligned(a.create<over_aligned>(), 32u));
+    a.create<char>('c');
+    BOOST_TEST(is_aligned(a.allocate(1, 64), 64u));
+}
+
+BOOST_AUTO_TEST_CASE(large_allocations_get_a_chunk_of_their_own)
+{
+    mock::detail::arena a;
+    a.create<int>(1);
+    char* p = static_cast<char*>(a.allocate(100000, 1));
+    p[0] = p[99999] = 'x';
+    BOOST_TEST(a.chunks() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(clearing_an_arena_keeps_its_largest_chunk_for_reuse)
+{
+    mock::detail::arena a;
+    for(int i = 0; i < 1000; ++i)
+        a.create<int>(i);
+    BOOST_TEST(a.chunks() > 1u);
+    a.clear();
+    BOOST_TEST(a.chunks() == 1u);
+    for(int i = 0; i < 500; ++i)
+        a.create<int>(i);
+    BOOST_TEST(a.chunks() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(objects_owning_memory_can_be_created_in_an_arena)
+{
+    mock::detail::arena a;
+    std::string* s = a.create<std::string>(1000, 'x');
+    BOOST_TEST(s->size() == 1000u);
+    s->~basic_string();
+}
+
+BOOST_AUTO_TEST_CASE(values_replaced_by_one_of_the_same_type_reuse_their_place_in_the_arena)
+{
+    mock::detail::arena a;
+    mock::detail::action<std::string, std::string()> action(a);
+    for(int i = 0; i < 1000; ++i)
+    {
+        action.returns(std::string(100, 'x'));
+        action.moves(std::string(100, 'y'));
+    }
+    BOOST_TEST(a.chunks() == 1u);
+    BOOST_TEST(action.trigger() == std::string(100, 'y'));
+    action.returns("z");
+    BOOST_TEST(action.trigger() == "z");
+}
@@ -0,0 +1,91 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <turtle/detail/callable.hpp>
+#include <boost/test/unit_test.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace {
+int twice(int i)
+{
+    return 2 * i;
+}
+
+// At least as large as a pointer: GCC 12 warns about array bounds when inlining the call through a member function
+// pointer on a smaller object as it cannot rule out looking up a virtual function
+struct object
+{
+    int value() const { return static_cast<int>(value_); }
+    std::size_t value_ = 7;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(default_callable_is_empty)
+{
+    const mock::detail::callable<int()> c;
+    BOOST_TEST(!c);
+}
+
+BOOST_AUTO_TEST_CASE(callable_calls_function_pointers)
+{
+    mock::detail::callable<int(int)> c;
+    c.emplace(&twice);
+    BOOST_TEST(c.is_inline());
+    BOOST_TEST(c(21) == 42);
+    c.reset();
+    BOOST_TEST(!c);
+}
+
+BOOST_AUTO_TEST_CASE(small_functors_are_stored_inline_and_large_ones_on_the_heap)
+{
+    mock::detail::callable<std::size_t()> c;
+    const std::string s = "text";
+    c.emplace([&s]() { return s.size(); });
+    BOOST_TEST(c.is_inline());
+    BOOST_TEST(c() == 4u);
+    char large[4 * MOCK_CALLABLE_BUFFER_SIZE] = "large";
+    c.emplace([large]() { return std::string(large).size(); });
+    BOOST_TEST(!c.is_inline());
+    BOOST_TEST(c() == 5u);
+}
+
+BOOST_AUTO_TEST_CASE(callable_accepts_move_only_functors)
+{
+    mock::detail::callable<int()> c;
+    std::unique_ptr<int> p(new int(3));
+    c.emplace([p = std::move(p)]() { return *p; });
+    BOOST_TEST(c() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(callable_returning_void_discards_the_result_of_the_functor)
+{
+    mock::detail::callable<void(int)> c;
+    int calls = 0;
+    c.emplace([&calls](int i) { return calls += i; });
+    c(2);
+    BOOST_TEST(calls == 2);
+}
+
+BOOST_AUTO_TEST_CASE(callable_calls_pointers_to_member_functions)
+{
+    mock::detail::callable<int(const object&)> c;
+    c.emplace(&object::value);
+    const object o;
+    BOOST_TEST(c(o) == 7);
+}
+
+BOOST_AUTO_TEST_CASE(null_function_pointers_and_empty_functions_are_detected)
+{
+    int (*f)(int) = nullptr;
+    BOOST_TEST(mock::detail::is_null(f));
+    BOOST_TEST(!mock::detail::is_null(&twice));
+    BOOST_TEST(mock::detail::is_null(std::function<void()>()));
+    BOOST_TEST(!mock::detail::is_null([]() {}));
+}
@@ -14,6 +14,7 @@
 #include <boost/test/unit_test.hpp>
 #include <functional>
 #include <memory>
+#include <string>
 #include <type_traits>
 
 // static
@@ -386,6 +387,84 @@ BOOST_FIXTURE_TEST_CASE(triggering_an_expectation_with_failing_custom_constraint
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(constraints_are_evaluated_until_the_first_failure, mock_error_fixture)
+{
+    mock::detail::function<void(int, int)> f;
+    int calls = 0;
+    const auto counting_constraint = [&calls](int) {
+        ++calls;
+        return true;
+    };
+    f.expect().with(&custom_constraint, counting_constraint);
+    CHECK_ERROR(f(1, 2), "unexpected call", 0, "?( 1, 2 )\n. unlimited().with( ?, ? )");
+    BOOST_TEST(calls == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(cheaper_constraints_are_evaluated_first, mock_error_fixture)
+{
+    mock::detail::function<void(int, int, int)> f;
+    int calls = 0;
+    const auto counting_constraint = [&calls](int) {
+        ++calls;
+        return true;
+    };
+    int retrieved = 0;
+    f.expect().with(counting_constraint, mock::retrieve(retrieved), 3);
+    f.expect().with(counting_constraint, mock::retrieve(retrieved), mock::less(3));
+    CHECK_ERROR(f(1, 2, 4), "unexpected call", 0, "?( 1, 2, 4 )\n. unlimited().with( ?, retrieve( 0 ), 3 )\n"
+                                                   ". unlimited().with( ?, retrieve( 0 ), less( 3 ) )");
+    BOOST_TEST(calls == 0);
+    BOOST_TEST(retrieved == 0);
+    f(1, 2, 3);
+    BOOST_TEST(calls == 1);
+    BOOST_TEST(retrieved == 2);
+    CHECK_CALLS(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(expectations_without_constraints_match_any_arguments_until_constrained, mock_error_fixture)
+{
+    mock::detail::function<int(int, const std::string&)> f;
+    auto e = f.expect();
+    e.returns(1);
+    BOOST_TEST(f(1, "first") == 1);
+    BOOST_TEST(f(2, "second") == 1);
+    CHECK_CALLS(2);
+    e.with(1, "first");
+    BOOST_TEST(f(1, "first") == 1);
+    CHECK_CALLS(1);
+    CHECK_ERROR(f(2, "second"), "unexpected call", 0, "?( 2, \"second\" )\n. unlimited().with( 1, \"first\" )");
+}
+
+#ifdef MOCK_THREAD_SAFE
+
+#    include <boost/thread.hpp>
+#    include <atomic>
+
+BOOST_FIXTURE_TEST_CASE(stateful_constraints_are_evaluated_by_one_call_at_a_time, mock_error_fixture)
+{
+    std::atomic<int> evaluating(0);
+    std::atomic<bool> overlapped(false);
+    mock::detail::function<void(int)> f;
+    f.expect().with([&evaluating, &overlapped](int) {
+        if(++evaluating > 1)
+            overlapped = true;
+        boost::this_thread::yield();
+        --evaluating;
+        return true;
+    });
+    boost::thread_group group;
+    for(int i = 0; i < 8; ++i)
+        group.create_thread([&f]() {
+            for(int j = 0; j < 1000; ++j)
+                f(j);
+        });
+    group.join_all();
+    BOOST_TEST(!overlapped);
+    CHECK_CALLS(8000);
+}
+
+#endif // MOCK_THREAD_SAFE
+
 // BOOST_FIXTURE_TEST_CASE( literal_zero_can_be_used_in_place_of_null_pointers_in_constraints, mock_error_fixture )
 //{
 //   mock::detail::function< void( int* ) > f;
@@ -635,6 +714,25 @@ BOOST_FIXTURE_TEST_CASE(triggering_an_expectation_returns_by_reference, mock_err
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(the_last_action_set_on_an_expectation_is_triggered, mock_error_fixture)
+{
+    mock::detail::function<int()> f;
+    int i = 1;
+    auto e = f.expect();
+    e.returns(2);
+    e.returns(std::ref(i));
+    i = 3;
+    BOOST_TEST(f() == 3);
+    e.returns(4);
+    BOOST_TEST(f() == 4);
+    e.throws(std::runtime_error("error"));
+    BOOST_CHECK_THROW(f(), std::runtime_error);
+    e.moves(5);
+    BOOST_TEST(f() == 5);
+    BOOST_TEST(f() == 5);
+    CHECK_CALLS(5);
+}
+
 namespace {
 int custom_result()
 {
@@ -734,6 +832,281 @@ BOOST_FIXTURE_TEST_CASE(best_expectation_is_selected_first, mock_error_fixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(exhausted_expectations_are_still_reported_and_verified, mock_error_fixture)
+{
+    mock::detail::function<void(int)> f;
+    for(int i = 0; i < 3; ++i)
+        f.expect().once().with(i);
+    f.expect().once().with(3);
+    f(1);
+    f(0);
+    f(2);
+    CHECK_ERROR(f(4),
+                "unexpected call",
+                3,
+                "?( 4 )\nv once().with( 0 )\nv once().with( 1 )\nv once().with( 2 )\n. once().with( 3 )");
+    CHECK_ERROR(BOOST_CHECK(!f.verify()),
+                "verification failed",
+                0,
+                "?\nv once().with( 0 )\nv once().with( 1 )\nv once().with( 2 )\n. once().with( 3 )");
+    f.reset();
+}
+
+BOOST_FIXTURE_TEST_CASE(exhausted_expectation_can_be_revived_by_changing_its_invocation, mock_error_fixture)
+{
+    mock::detail::function<int()> f;
+    auto e = f.expect();
+    e.once().returns(1);
+    BOOST_TEST(f() == 1);
+    CHECK_ERROR(f(), "unexpected call", 1, "?()\nv once()");
+    e.exactly(2);
+    BOOST_TEST(f() == 1);
+    BOOST_TEST(f() == 1);
+    CHECK_CALLS(2);
+    e.never();
+    CHECK_ERROR(f(), "unexpected call", 0, "?()\nv never()");
+    e.once();
+    BOOST_TEST(f() == 1);
+    CHECK_CALLS(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(exhausted_expectation_dropped_by_later_calls_can_be_revived, mock_error_fixture)
+{
+    mock::detail::function<int(int)> f;
+    auto e = f.expect();
+    e.once().with(0).returns(0);
+    for(int i = 1; i <= 20; ++i)
+        f.expect().once().with(i).returns(i);
+    f.expect().returns(-1);
+    for(int i = 0; i <= 20; ++i)
+        BOOST_TEST(f(i) == i);
+    // Skipping all the exhausted expectations drops them
+    BOOST_TEST(f(0) == -1);
+    BOOST_TEST(f(0) == -1);
+    e.once();
+    BOOST_TEST(f(0) == 0);
+    CHECK_CALLS(24);
+}
+
+// index
+
+BOOST_FIXTURE_TEST_CASE(indexed_expectations_are_selected_by_their_first_argument, mock_error_fixture)
+{
+    {
+        mock::detail::function<int(int, int)> f;
+        f.index();
+        for(int i = 0; i < 100; ++i)
+            f.expect().with(i, mock::any).returns(i);
+        BOOST_TEST(f(42, 0) == 42);
+        BOOST_TEST(f(7, 0) == 7);
+        CHECK_CALLS(2);
+    }
+    {
+        mock::detail::function<void(int)> f;
+        f.index();
+        f.expect().once().with(1);
+        f.expect().once().with(2);
+        f(2);
+        CHECK_ERROR(f(2), "unexpected call", 1, "?( 2 )\n. once().with( 1 )\nv once().with( 2 )");
+        f(1);
+        CHECK_CALLS(1);
+    }
+    {
+        mock::detail::function<void(const std::string&)> f;
+        f.expect().once().with("first");
+        f.expect().once().with(mock::equal(std::string("second")));
+        f.index();
+        f("second");
+        f("first");
+        CHECK_CALLS(2);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(indexed_expectations_keep_their_declaration_order, mock_error_fixture)
+{
+    mock::detail::function<int(int)> f;
+    f.index();
+    f.expect().once().with(mock::less(3)).returns(1);
+    f.expect().once().with(2).returns(2);
+    f.expect().with(mock::any).returns(3);
+    f.expect().with(2).returns(4);
+    BOOST_TEST(f(2) == 1);
+    BOOST_TEST(f(2) == 2);
+    BOOST_TEST(f(2) == 3);
+    BOOST_TEST(f(5) == 3);
+    CHECK_CALLS(4);
+}
+
+BOOST_FIXTURE_TEST_CASE(indexed_expectations_take_constraints_set_after_a_call_into_account, mock_error_fixture)
+{
+    mock::detail::function<int(int)> f;
+    f.index();
+    f.expect().once().with(1).returns(1);
+    BOOST_TEST(f(1) == 1);
+    auto e = f.expect();
+    e.returns(2);
+    e.with(2);
+    BOOST_TEST(f(2) == 2);
+    CHECK_CALLS(2);
+    f.reset();
+    f.expect().with(3).returns(3);
+    BOOST_TEST(f(3) == 3);
+    CHECK_CALLS(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(equal_constraint_on_an_lvalue_is_not_indexed_as_it_may_change, mock_error_fixture)
+{
+    mock::detail::function<void(int)> f;
+    f.index();
+    int expected = 1;
+    f.expect().once().with(mock::equal(expected));
+    expected = 2;
+    f(2);
+    CHECK_CALLS(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(indexing_a_function_with_an_unsupported_first_argument_has_no_effect, mock_error_fixture)
+{
+    mock::detail::function<void(const char*)> f;
+    f.index();
+    const char* expected = "first";
+    f.expect().once().with(expected);
+    f(std::string("first").c_str());
+    CHECK_CALLS(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(indexed_range_expectations_are_selected_in_declaration_order, mock_error_fixture)
+{
+    mock::detail::function<int(double)> f;
+    f.index();
+    f.expect().once().with(mock::near(2.0, 0.5)).returns(1);
+    f.expect().with(2.).returns(2);
+    f.expect().with(mock::greater_equal(0.) && mock::less(4.)).returns(3);
+    f.expect().with(mock::any).returns(4);
+    BOOST_TEST(f(2) == 1);
+    BOOST_TEST(f(2) == 2);
+    BOOST_TEST(f(2.5) == 3);
+    BOOST_TEST(f(4) == 4);
+    BOOST_TEST(f(-0.1) == 4);
+    CHECK_CALLS(5);
+}
+
+BOOST_FIXTURE_TEST_CASE(exhausted_indexed_range_expectations_are_skipped, mock_error_fixture)
+{
+    mock::detail::function<void(int)> f;
+    f.index();
+    f.expect().once().with(mock::less(3));
+    f.expect().once().with(mock::less(5));
+    f(1);
+    f(1);
+    CHECK_CALLS(2);
+    CHECK_ERROR(f(1), "unexpected call", 0, "?( 1 )\nv once().with( less( 3 ) )\nv once().with( less( 5 ) )");
+}
+
+namespace {
+struct counted_at_least
+{
+    counted_at_least(int min, int& evaluations) : min_(min), evaluations_(&evaluations) {}
+    bool operator()(int actual) const
+    {
+        ++*evaluations_;
+        return actual >= min_;
+    }
+    friend std::ostream& operator<<(std::ostream& s, const counted_at_least&) { return s << "counted_at_least"; }
+    int min_;
+    int* evaluations_;
+};
+} // namespace
+
+namespace mock { namespace detail {
+    template<>
+    struct constraint_monotony<int, counted_at_least> : std::integral_constant<monotony, monotony::increasing>
+    {};
+}} // namespace mock::detail
+
+BOOST_FIXTURE_TEST_CASE(range_bounds_are_computed_once_when_first_building_the_index, mock_error_fixture)
+{
+    int evaluations = 0;
+    {
+        mock::detail::function<int(int)> f;
+        f.expect().with(mock::constraint<counted_at_least>(counted_at_least(3, evaluations))).returns(1);
+        BOOST_TEST(f(5) == 1);
+        BOOST_TEST(evaluations == 1);
+        CHECK_CALLS(1);
+    }
+    evaluations = 0;
+    mock::detail::function<int(int)> f;
+    f.index();
+    f.expect().with(mock::constraint<counted_at_least>(counted_at_least(3, evaluations))).returns(1);
+    BOOST_TEST(evaluations == 0);
+    BOOST_TEST(f(5) == 1);
+    const int computed = evaluations - 1;
+    BOOST_TEST(computed > 0);
+    for(int i = 0; i < 3; ++i)
+    {
+        // Adding an expectation rebuilds the index
+        f.expect().with(-i).returns(0);
+        BOOST_TEST(f(5) == 1);
+        BOOST_TEST(evaluations == computed + i + 2);
+    }
+    CHECK_CALLS(4);
+}
+
+// freeze
+
+BOOST_FIXTURE_TEST_CASE(frozen_expectations_are_selected_in_declaration_order, mock_error_fixture)
+{
+    {
+        mock::detail::function<int(int)> f;
+        f.expect().once().with(mock::less(3)).returns(1);
+        f.expect().once().with(2).returns(2);
+        f.expect().with(mock::any).returns(3);
+        f.expect().with(2).returns(4);
+        f.freeze();
+        BOOST_TEST(f(2) == 1);
+        BOOST_TEST(f(2) == 2);
+        BOOST_TEST(f(2) == 3);
+        BOOST_TEST(f(5) == 3);
+        CHECK_CALLS(4);
+    }
+    {
+        mock::detail::function<void(const char*)> f;
+        f.expect().once().with("first");
+        f.expect().once().with("second");
+        f.freeze();
+        f("second");
+        f("first");
+        CHECK_CALLS(2);
+        CHECK_ERROR(f("first"), "unexpected call", 0, "?( \"first\" )\nv once().with( \"first\" )\nv once().with( \"second\" )");
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(changing_expectations_unfreezes_the_function, mock_error_fixture)
+{
+    mock::detail::function<int(int)> f;
+    f.expect().once().with(1).returns(1);
+    auto e = f.expect();
+    e.never().returns(2);
+    f.freeze();
+    BOOST_TEST(f(1) == 1);
+    CHECK_ERROR(f(2), "unexpected call", 1, "?( 2 )\nv once().with( 1 )\nv never().with( any )");
+    e.once();
+    BOOST_TEST(f(2) == 2);
+    CHECK_CALLS(1);
+    f.freeze();
+    e.once().with(3);
+    BOOST_TEST(f(3) == 2);
+    f.freeze();
+    f.expect().with(4).returns(4);
+    BOOST_TEST(f(4) == 4);
+    CHECK_CALLS(2);
+    f.freeze();
+    f.reset();
+    f.expect().returns(5);
+    BOOST_TEST(f(5) == 5);
+    CHECK_CALLS(1);
+}
+
 // error report
 
 namespace {
@@ -885,6 +1258,8 @@ BOOST_FIXTURE_TEST_CASE(adding_file_and_line_number_information, mock_error_fixt
 #ifdef MOCK_THREAD_SAFE
 
 #    include <boost/thread.hpp>
+#    include <atomic>
+#    include <future>
 
 namespace {
 void iterate(mock::detail::function<int()>& f)
@@ -908,4 +1283,222 @@ BOOST_FIXTURE_TEST_CASE(function_is_thread_safe, mock_error_fixture)
     CHECK_CALLS(100);
 }
 
+BOOST_FIXTURE_TEST_CASE(concurrent_calls_never_exceed_the_expected_count, mock_error_fixture)
+{
+    mock::detail::function<int()> f;
+    f.expect().exactly(500).returns(1);
+    f.expect().returns(0);
+    std::atomic<int> sum(0);
+    boost::thread_group group;
+    for(int i = 0; i < 10; ++i)
+        group.create_thread([&f, &sum]() {
+            for(int j = 0; j < 100; ++j)
+                sum += f();
+        });
+    group.join_all();
+    BOOST_TEST(sum == 500);
+    BOOST_TEST(f.verify());
+    CHECK_CALLS(1000);
+}
+
+BOOST_FIXTURE_TEST_CASE(thousands_of_threads_racing_on_bounded_expectations_consume_them_exactly, mock_error_fixture)
+{
+    mock::detail::function<int(int)> f;
+    f.expect().exactly(1000).with(0).returns(1);
+    f.expect().at_most(500).with(1).returns(1);
+    f.expect().returns(0);
+    std::atomic<int> sum(0);
+    boost::thread_group group;
+    for(int i = 0; i < 2000; ++i)
+        group.create_thread([&f, &sum]() { sum += f(0) + f(1); });
+    group.join_all();
+    BOOST_TEST(sum == 1500);
+    BOOST_TEST(f.verify());
+    CHECK_CALLS(4000);
+}
+
+namespace {
+struct tally
+{
+    explicit tally(int& count) : count_(&count) {}
+    bool operator()(int) const
+    {
+        ++*count_;
+        return true;
+    }
+    friend std::ostream& operator<<(std::ostream& s, const tally&) { return s << "tally"; }
+    int* count_;
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(custom_constraints_are_not_evaluated_concurrently, mock_error_fixture)
+{
+    int count = 0, functor_count = 0;
+    mock::detail::function<void(int, int)> f;
+    f.expect().with(mock::constraint<tally>(tally(count)), [&functor_count](int) { return ++functor_count > 0; });
+    boost::thread_group group;
+    for(int i = 0; i < 100; ++i)
+        group.create_thread([&f]() {
+            for(int j = 0; j < 100; ++j)
+                f(j, j);
+        });
+    group.join_all();
+    BOOST_TEST(count == 10000);
+    BOOST_TEST(functor_count == 10000);
+    CHECK_CALLS(10000);
+}
+
+BOOST_FIXTURE_TEST_CASE(custom_functors_checking_all_arguments_are_not_evaluated_concurrently, mock_error_fixture)
+{
+    int count = 0;
+    mock::detail::function<void(int, int)> f;
+    f.expect().with([&count](int, int) { return ++count > 0; });
+    boost::thread_group group;
+    for(int i = 0; i < 100; ++i)
+        group.create_thread([&f]() {
+            for(int j = 0; j < 100; ++j)
+                f(j, j);
+        });
+    group.join_all();
+    BOOST_TEST(count == 10000);
+    CHECK_CALLS(10000);
+}
+
+BOOST_FIXTURE_TEST_CASE(successful_calls_from_other_threads_are_reported_in_batches, mock_error_fixture)
+{
+    mock::detail::function<void()> f;
+    f.expect().exactly(3);
+    std::promise<void> called, done;
+    boost::thread t([&]() {
+        f();
+        f();
+        f();
+        called.set_value();
+        done.get_future().wait();
+    });
+    called.get_future().wait();
+    BOOST_TEST(mock_error_data.call_count == 0);
+    mock::detail::flush_calls();
+    CHECK_CALLS(3);
+    done.set_value();
+    t.join();
+    CHECK_CALLS(0);
+}
+
+BOOST_FIXTURE_TEST_CASE(verifying_a_function_reports_the_calls_buffered_from_other_threads, mock_error_fixture)
+{
+    mock::detail::function<void(int, int)> f;
+    f.expect().once();
+    mock_error_data.keep_call_context = true;
+    std::promise<void> called, done;
+    boost::thread t([&]() {
+        f(1, 2);
+        called.set_value();
+        done.get_future().wait();
+    });
+    called.get_future().wait();
+    BOOST_TEST(mock_error_data.call_count == 0);
+    BOOST_TEST(f.verify());
+    BOOST_TEST(mock_error_data.last_call_context == "?( ?, ? ) (buffered call from another thread)");
+    CHECK_CALLS(1);
+    done.set_value();
+    t.join();
+}
+
+BOOST_FIXTURE_TEST_CASE(function_can_be_called_again_from_an_action, mock_error_fixture)
+{
+    mock::detail::function<int()> f;
+    f.expect().once().calls([&f]() { return f() + 1; });
+    f.expect().returns(1);
+    BOOST_TEST(f() == 2);
+    CHECK_CALLS(2);
+}
+
+BOOST_FIXTURE_TEST_CASE(function_is_not_locked_while_running_an_action, mock_error_fixture)
+{
+    mock::detail::function<void()> f;
+    f.expect().once().calls([&f]() {
+        boost::thread t([&f]() { f.expect().once(); });
+        t.join();
+    });
+    f();
+    f();
+    BOOST_TEST(f.verify());
+    CHECK_CALLS(2);
+}
+
+BOOST_FIXTURE_TEST_CASE(resetting_a_function_from_its_action_keeps_it_alive_until_it_returns, mock_error_fixture)
+{
+    mock::detail::function<int()> f;
+    auto token = std::make_shared<int>(42);
+    const std::weak_ptr<int> observer = token;
+    f.expect().once().calls([&f, &observer, token]() {
+        f.reset();
+        return observer.expired() ? 0 : *token;
+    });
+    token.reset();
+    BOOST_TEST(f() == 42);
+    BOOST_TEST(observer.expired());
+    CHECK_CALLS(1);
+    f.expect().once().returns(1);
+    BOOST_TEST(f() == 1);
+    CHECK_CALLS(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(resetting_a_function_from_another_thread_keeps_running_actions_alive, mock_error_fixture)
+{
+    mock::detail::function<int()> f;
+    auto token = std::make_shared<int>(42);
+    const std::weak_ptr<int> observer = token;
+    std::promise<void> started, resumed;
+    auto resume = resumed.get_future().share();
+    f.expect().once().calls([&started, resume, token]() {
+        started.set_value();
+        resume.wait();
+        return *token;
+    });
+    token.reset();
+    int result = 0;
+    boost::thread t([&f, &result]() { result = f(); });
+    started.get_future().wait();
+    f.reset();
+    BOOST_TEST(!observer.expired());
+    resumed.set_value();
+    t.join();
+    BOOST_TEST(result == 42);
+    BOOST_TEST(observer.expired());
+    CHECK_CALLS(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(resetting_a_function_races_safely_with_calls_running_actions, mock_error_fixture)
+{
+    const std::string expected(100, 'a');
+    mock::detail::function<std::string()> f;
+    f.expect().calls([expected]() { return expected; });
+    std::atomic<bool> done(false);
+    std::atomic<int> mismatches(0);
+    boost::thread_group group;
+    for(int i = 0; i < 4; ++i)
+        group.create_thread([&]() {
+            while(!done)
+            {
+                try
+                {
+                    if(f() != expected)
+                        ++mismatches;
+                } catch(...)
+                {}
+            }
+        });
+    for(int i = 0; i < 1000; ++i)
+    {
+        f.reset();
+        f.expect().calls([expected]() { return expected; });
+    }
+    done = true;
+    group.join_all();
+    BOOST_TEST(mismatches == 0);
+    mock_error_data.reset();
+}
+
 #endif // MOCK_THREAD_SAFE
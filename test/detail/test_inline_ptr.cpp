@@ -0,0 +1,122 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <turtle/detail/inline_ptr.hpp>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+
+namespace {
+struct base
+{
+    explicit base(int& instances) : instances(instances) { ++instances; }
+    virtual ~base() { --instances; }
+    virtual int value() const = 0;
+
+    int& instances;
+};
+
+struct small : base
+{
+    small(int& instances, int value) : base(instances), value_(value) {}
+    int value() const override { return value_; }
+
+    int value_;
+};
+
+struct large : base
+{
+    explicit large(int& instances) : base(instances), data() {}
+    int value() const override { return 42; }
+
+    char data[256];
+};
+
+struct throwing : base
+{
+    explicit throwing(int& instances) : base(instances) { throw std::runtime_error("construction failed"); }
+    int value() const override { return 0; }
+};
+
+typedef mock::detail::inline_ptr<base, 4 * sizeof(void*)> ptr_type;
+} // namespace
+
+BOOST_AUTO_TEST_CASE(default_inline_ptr_is_empty)
+{
+    const ptr_type p;
+    BOOST_TEST(!p);
+    BOOST_TEST(!p.get());
+}
+
+BOOST_AUTO_TEST_CASE(small_objects_are_stored_inline)
+{
+    int instances = 0;
+    {
+        ptr_type p;
+        p.emplace<small>(instances, 7);
+        BOOST_TEST(p.is_inline());
+        BOOST_TEST(p->value() == 7);
+        BOOST_TEST(instances == 1);
+    }
+    BOOST_TEST(instances == 0);
+}
+
+BOOST_AUTO_TEST_CASE(large_objects_are_stored_on_the_heap)
+{
+    int instances = 0;
+    {
+        ptr_type p;
+        p.emplace<large>(instances);
+        BOOST_TEST(!p.is_inline());
+        BOOST_TEST((*p).value() == 42);
+        BOOST_TEST(instances == 1);
+    }
+    BOOST_TEST(instances == 0);
+}
+
+BOOST_AUTO_TEST_CASE(emplacing_destroys_the_previous_object)
+{
+    int instances = 0;
+    ptr_type p;
+    p.emplace<small>(instances, 1);
+    p.emplace<large>(instances);
+    BOOST_TEST(instances == 1);
+    p.emplace<small>(instances, 2);
+    BOOST_TEST(instances == 1);
+    BOOST_TEST(p->value() == 2);
+    p.reset();
+    BOOST_TEST(instances == 0);
+    BOOST_TEST(!p);
+}
+
+BOOST_AUTO_TEST_CASE(failing_to_construct_an_object_leaves_the_pointer_empty)
+{
+    int instances = 0;
+    ptr_type p;
+    p.emplace<small>(instances, 1);
+    BOOST_CHECK_THROW(p.emplace<throwing>(instances), std::runtime_error);
+    BOOST_TEST(!p);
+    BOOST_TEST(instances == 0);
+}
+
+BOOST_AUTO_TEST_CASE(large_objects_can_be_stored_in_an_arena)
+{
+    int instances = 0;
+    mock::detail::arena a;
+    {
+        ptr_type p;
+        p.emplace_in<small>(a, instances, 3);
+        BOOST_TEST(p.is_inline());
+        BOOST_TEST(a.chunks() == 0u);
+        p.emplace_in<large>(a, instances);
+        BOOST_TEST(!p.is_inline());
+        BOOST_TEST(p->value() == 42);
+        BOOST_TEST(a.chunks() == 1u);
+        BOOST_TEST(instances == 1);
+    }
+    BOOST_TEST(instances == 0);
+}
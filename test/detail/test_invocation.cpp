@@ -118,3 +118,15 @@ BOOST_AUTO_TEST_CASE(between)
     // First must be equal or less than 2nd
     BOOST_CHECK_THROW(mock::detail::between invalid(2, 1), std::invalid_argument);
 }
+
+BOOST_AUTO_TEST_CASE(replacing_an_invocation_resets_its_count_and_kind)
+{
+    mock::detail::invocation invocation = mock::detail::once();
+    BOOST_TEST(invocation.invoke());
+    BOOST_TEST(invocation.exhausted());
+    invocation = mock::detail::exactly(2);
+    BOOST_TEST(!invocation.exhausted());
+    BOOST_TEST(to_string(invocation) == "exactly( 0/2 )");
+    BOOST_TEST(invocation.invoke());
+    BOOST_TEST(to_string(invocation) == "exactly( 1/2 )");
+}
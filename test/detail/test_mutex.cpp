@@ -0,0 +1,90 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <turtle/detail/mutex.hpp>
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <utility>
+
+BOOST_AUTO_TEST_CASE(shared_mutex_is_reentrant_in_any_mode)
+{
+    mock::detail::shared_mutex m;
+    {
+        mock::detail::shared_lock outer(m);
+        mock::detail::shared_lock inner(m);
+        mock::detail::exclusive_lock upgrade(m);
+        mock::detail::exclusive_lock again(m);
+        mock::detail::shared_lock nested(m);
+    }
+    {
+        mock::detail::exclusive_lock outer(m);
+        mock::detail::shared_lock inner(m);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(owning_lock_can_be_moved)
+{
+    const auto m = std::make_shared<mock::detail::shared_mutex>();
+    mock::detail::lock l1(m);
+    mock::detail::lock l2(std::move(l1));
+    mock::detail::shared_lock nested(*m);
+}
+
+#ifdef MOCK_THREAD_SAFE
+
+#    include <boost/thread.hpp>
+
+BOOST_AUTO_TEST_CASE(shared_mutex_is_released_after_upgrading)
+{
+    mock::detail::shared_mutex m;
+    {
+        mock::detail::shared_lock shared(m);
+        mock::detail::exclusive_lock upgrade(m);
+    }
+    bool locked = false;
+    boost::thread t([&m, &locked]() {
+        mock::detail::exclusive_lock _(m);
+        locked = true;
+    });
+    t.join();
+    BOOST_TEST(locked);
+}
+
+BOOST_AUTO_TEST_CASE(shared_mutex_excludes_shared_holders_while_locked_exclusively)
+{
+    mock::detail::shared_mutex m;
+    int first = 0, second = 0;
+    bool consistent = true;
+    boost::thread_group group;
+    for(int i = 0; i < 4; ++i)
+        group.create_thread([&]() {
+            for(int j = 0; j < 10000; ++j)
+            {
+                if(j % 4)
+                {
+                    mock::detail::shared_lock _(m);
+                    if(first != second)
+                    {
+                        mock::detail::exclusive_lock report(m);
+                        consistent = false;
+                    }
+                } else
+                {
+                    mock::detail::shared_lock shared(m);
+                    mock::detail::exclusive_lock _(m);
+                    ++first;
+                    ++second;
+                }
+            }
+        });
+    group.join_all();
+    BOOST_TEST(consistent);
+    BOOST_TEST(first == 10000);
+}
+
+#endif // MOCK_THREAD_SAFE
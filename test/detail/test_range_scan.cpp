@@ -0,0 +1,103 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <turtle/constraints.hpp>
+#include <turtle/detail/expectation_index.hpp>
+#include <turtle/detail/range_scan.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+namespace {
+template<typename Actual, typename Constraint>
+bool bounds(const mock::constraint<Constraint>& c, double& lower, double& upper)
+{
+    return mock::detail::range_key<Actual, mock::constraint<Constraint>>(c).bounds(lower, upper);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(scanning_ranges_returns_the_first_one_containing_the_value)
+{
+    std::srand(42);
+    for(std::size_t size = 0; size < 20; ++size)
+    {
+        std::vector<double> lower, upper;
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            lower.push_back(std::rand() % 10);
+            upper.push_back(lower.back() + std::rand() % 3);
+        }
+        for(std::size_t first = 0; first <= size; ++first)
+        {
+            for(double value = -1; value < 13; value += 0.5)
+            {
+                std::size_t expected = first;
+                while(expected < size && !(lower[expected] <= value && value <= upper[expected]))
+                    ++expected;
+                BOOST_TEST(mock::detail::scan_ranges(lower.data(), upper.data(), first, size, value) == expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(nan_is_within_no_range)
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+    const std::vector<double> lower(5, -infinity), upper(5, infinity);
+    BOOST_TEST(mock::detail::scan_ranges(lower.data(), upper.data(), 0, 5, std::numeric_limits<double>::quiet_NaN()) ==
+               5u);
+}
+
+BOOST_AUTO_TEST_CASE(comparison_constraints_on_integers_are_ranges)
+{
+    double lower, upper;
+    BOOST_TEST(bounds<int>(mock::less(3), lower, upper));
+    BOOST_TEST(lower == std::numeric_limits<int>::min());
+    BOOST_TEST(upper == 2);
+    BOOST_TEST(bounds<const int&>(mock::greater_equal(3), lower, upper));
+    BOOST_TEST(lower == 3);
+    BOOST_TEST(upper == std::numeric_limits<int>::max());
+    BOOST_TEST(bounds<unsigned char>(mock::greater(3.5), lower, upper));
+    BOOST_TEST(lower == 4);
+    BOOST_TEST(upper == 255);
+    BOOST_TEST(bounds<int>(mock::greater(0) && mock::less_equal(7), lower, upper));
+    BOOST_TEST(lower == 1);
+    BOOST_TEST(upper == 7);
+}
+
+BOOST_AUTO_TEST_CASE(comparison_constraints_on_floating_points_are_ranges)
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+    double lower, upper;
+    BOOST_TEST(bounds<double>(mock::less_equal(1.5), lower, upper));
+    BOOST_TEST(lower == -infinity);
+    BOOST_TEST(upper == 1.5);
+    BOOST_TEST(bounds<double>(mock::greater(1.5), lower, upper));
+    BOOST_TEST(lower == std::nextafter(1.5, infinity));
+    BOOST_TEST(upper == infinity);
+    BOOST_TEST(bounds<float>(mock::less(1), lower, upper));
+    BOOST_TEST(upper == std::nextafter(1.f, 0.f));
+    BOOST_TEST(bounds<double>(mock::near(10, 0.5), lower, upper));
+    BOOST_TEST(lower == 9.5);
+    BOOST_TEST(upper == 10.5);
+}
+
+BOOST_AUTO_TEST_CASE(constraints_without_values_or_changing_order_are_not_ranges)
+{
+    double lower, upper;
+    BOOST_TEST(!bounds<double>(mock::less(std::numeric_limits<double>::quiet_NaN()), lower, upper));
+    BOOST_TEST(!bounds<int>(mock::greater(0) && mock::less(0), lower, upper));
+    BOOST_TEST(!bounds<int>(mock::less(3u), lower, upper));
+    BOOST_TEST(!bounds<int>(mock::near(3, 1), lower, upper));
+    BOOST_TEST(!bounds<long long>(mock::less(3), lower, upper));
+    BOOST_TEST(!bounds<int>(mock::less(3) || mock::greater(5), lower, upper));
+    const int expected = 3;
+    BOOST_TEST(!bounds<int>(mock::less(std::cref(expected)), lower, upper));
+}
@@ -0,0 +1,107 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <turtle/detail/segmented_vector.hpp>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+struct non_movable
+{
+    non_movable(int value, int& instances) : value(value), instances(instances) { ++instances; }
+    non_movable(const non_movable&) = delete;
+    non_movable& operator=(const non_movable&) = delete;
+    ~non_movable() { --instances; }
+
+    int value;
+    int& instances;
+};
+
+struct throwing
+{
+    throwing(bool fail)
+    {
+        if(fail)
+            throw std::runtime_error("construction failed");
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(empty_segmented_vector_has_no_elements)
+{
+    const mock::detail::segmented_vector<int> v;
+    BOOST_TEST(v.empty());
+    BOOST_TEST(v.size() == 0u);
+    BOOST_TEST((v.begin() == v.end()));
+}
+
+BOOST_AUTO_TEST_CASE(elements_are_iterated_in_insertion_order)
+{
+    mock::detail::segmented_vector<int> v;
+    std::vector<int> expected;
+    for(int i = 0; i < 100; ++i)
+    {
+        BOOST_TEST(v.emplace_back(i) == i);
+        BOOST_TEST(v.back() == i);
+        expected.push_back(i);
+        BOOST_TEST(std::vector<int>(v.begin(), v.end()) == expected);
+    }
+    BOOST_TEST(v.size() == 100u);
+}
+
+BOOST_AUTO_TEST_CASE(element_addresses_are_stable_when_adding_elements)
+{
+    int instances = 0;
+    mock::detail::segmented_vector<non_movable> v;
+    std::vector<const non_movable*> addresses;
+    for(int i = 0; i < 1000; ++i)
+        addresses.push_back(&v.emplace_back(i, instances));
+    BOOST_TEST(instances == 1000);
+    int i = 0;
+    for(const auto& e : v)
+    {
+        BOOST_TEST(&e == addresses[i]);
+        BOOST_TEST(e.value == i);
+        ++i;
+    }
+    BOOST_TEST(i == 1000);
+}
+
+BOOST_AUTO_TEST_CASE(clearing_destroys_all_elements_and_allows_to_add_new_ones)
+{
+    int instances = 0;
+    {
+        mock::detail::segmented_vector<non_movable> v;
+        for(int i = 0; i < 10; ++i)
+            v.emplace_back(i, instances);
+        v.clear();
+        BOOST_TEST(instances == 0);
+        BOOST_TEST(v.empty());
+        BOOST_TEST((v.begin() == v.end()));
+        v.emplace_back(42, instances);
+        v.emplace_back(43, instances);
+        v.emplace_back(44, instances);
+        BOOST_TEST(instances == 3);
+        BOOST_TEST(v.size() == 3u);
+        BOOST_TEST(v.begin()->value == 42);
+        BOOST_TEST(v.back().value == 44);
+    }
+    BOOST_TEST(instances == 0);
+}
+
+BOOST_AUTO_TEST_CASE(failing_to_construct_an_element_leaves_the_vector_unchanged)
+{
+    mock::detail::segmented_vector<throwing> v;
+    v.emplace_back(false);
+    BOOST_CHECK_THROW(v.emplace_back(true), std::runtime_error);
+    BOOST_TEST(v.size() == 1u);
+    BOOST_TEST(std::distance(v.begin(), v.end()) == 1);
+    v.emplace_back(false);
+    BOOST_TEST(std::distance(v.begin(), v.end()) == 2);
+}
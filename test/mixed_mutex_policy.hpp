@@ -0,0 +1,20 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_TEST_MIXED_MUTEX_POLICY_HPP_INCLUDED
+#define MOCK_TEST_MIXED_MUTEX_POLICY_HPP_INCLUDED
+
+#ifdef BOOST_AUTO_TEST_MAIN
+#    undef BOOST_AUTO_TEST_MAIN
+#endif
+
+#include <turtle/mock.hpp>
+
+void call(mock::detail::function<void()>& f);
+
+#endif // MOCK_TEST_MIXED_MUTEX_POLICY_HPP_INCLUDED
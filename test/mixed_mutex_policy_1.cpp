@@ -0,0 +1,16 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#define MOCK_MUTEX_POLICY mock::spin_mutex
+#define MOCK_MUTEX_POLICY_TAG spin_mutex
+#include "mixed_mutex_policy.hpp"
+
+void call(mock::detail::function<void()>& f)
+{
+    f();
+}
@@ -0,0 +1,17 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "mixed_mutex_policy.hpp"
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(mock_internals_built_with_different_mutex_policies_do_not_link)
+{
+    mock::detail::function<void()> f;
+    f.expect().once();
+    call(f);
+}
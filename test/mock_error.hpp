@@ -24,6 +24,8 @@ struct mock_error_data_t : mock::detail::singleton<mock_error_data_t>
         error_count = 0;
         last_message.clear();
         last_context.clear();
+        last_call_context.clear();
+        keep_call_context = false;
     }
     bool verify() { return error_count == 0; }
 
@@ -44,8 +46,10 @@ struct mock_error_data_t : mock::detail::singleton<mock_error_data_t>
 
     int call_count = 0;
     int error_count = 0;
-    std::string last_message, last_context, last_file;
+    std::string last_message, last_context, last_file, last_call_context;
     int last_line = 0;
+    /// Serialize the context of calls into last_call_context, which is not lazy anymore
+    bool keep_call_context = false;
     MOCK_SINGLETON_CONS(mock_error_data_t);
 };
 MOCK_SINGLETON_INST(mock_error_data)
@@ -59,9 +63,15 @@ struct mock_error
     static void pass(const char* /*file*/, int /*line*/) {}
 
     template<typename Context>
-    static void call(const Context& /*context*/, const char* /*file*/, int /*line*/)
+    static void call(const Context& context, const char* /*file*/, int /*line*/)
     {
         mock_error_data.call();
+        if(mock_error_data.keep_call_context)
+        {
+            std::ostringstream s;
+            s << context;
+            mock_error_data.last_call_context = s.str();
+        }
     }
 
     template<typename Context>
@@ -0,0 +1,32 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MOCK_TEST_SILENT_ERROR_HPP_INCLUDED
+#define MOCK_TEST_SILENT_ERROR_HPP_INCLUDED
+
+#define MOCK_ERROR_POLICY silent_error
+#include <cstdlib>
+#include <stdexcept>
+
+/// Error handler for benchmarks which reports nothing and aborts the program on failure
+template<typename Result>
+struct silent_error
+{
+    static Result abort() { throw std::runtime_error("aborted"); }
+    static void pass(const char*, int) {}
+    template<typename Context>
+    static void fail(const char*, const Context&, const char* = "", int = 0)
+    {
+        std::abort();
+    }
+    template<typename Context>
+    static void call(const Context&, const char*, int)
+    {}
+};
+
+#endif // MOCK_TEST_SILENT_ERROR_HPP_INCLUDED
@@ -13,6 +13,9 @@
 #include <boost/test/unit_test.hpp>
 #include <cmath>
 #include <functional>
+#include <limits>
+#include <map>
+#include <vector>
 
 namespace {
 struct my_custom_mock
@@ -576,6 +579,8 @@ MOCK_BASE_CLASS(my_boost_pp_comma_mock, my_base<int BOOST_PP_COMMA() int>)
 #ifdef MOCK_THREAD_SAFE
 
 #    include <boost/thread.hpp>
+#    include <atomic>
+#    include <future>
 
 namespace {
 void create_class()
@@ -623,6 +628,25 @@ BOOST_FIXTURE_TEST_CASE(mock_functor_creation_is_thread_safe, mock_error_fixture
     CHECK_CALLS(100);
 }
 
+BOOST_FIXTURE_TEST_CASE(thousands_of_mock_functors_can_be_created_in_parallel, mock_error_fixture)
+{
+    std::atomic<int> mismatches(0);
+    boost::thread_group group;
+    for(int t = 0; t < 8; ++t)
+        group.create_thread([&mismatches]() {
+            for(int i = 0; i < 1000; ++i)
+            {
+                MOCK_FUNCTOR(f, int(int));
+                MOCK_EXPECT(f).once().with(i).returns(i);
+                if(f(i) != i || !mock::verify(f))
+                    ++mismatches;
+            }
+        });
+    group.join_all();
+    BOOST_TEST(mismatches == 0);
+    CHECK_CALLS(8000);
+}
+
 namespace {
 void iterate(my_mock& m)
 {
@@ -641,6 +665,26 @@ BOOST_FIXTURE_TEST_CASE(mock_class_is_thread_safe, mock_error_fixture)
     CHECK_CALLS(100);
 }
 
+BOOST_FIXTURE_TEST_CASE(calls_buffered_from_another_thread_are_reported_with_the_name_of_the_method, mock_error_fixture)
+{
+    my_mock m;
+    MOCK_EXPECT(m.my_tag).once().with(3).returns(42);
+    mock_error_data.keep_call_context = true;
+    std::promise<void> called, done;
+    boost::thread t([&]() {
+        m.my_method(3);
+        called.set_value();
+        done.get_future().wait();
+    });
+    called.get_future().wait();
+    BOOST_TEST(mock_error_data.call_count == 0);
+    BOOST_TEST(mock::verify(m));
+    BOOST_TEST(mock_error_data.last_call_context == "m.my_mock::my_tag( ? ) (buffered call from another thread)");
+    CHECK_CALLS(1);
+    done.set_value();
+    t.join();
+}
+
 #endif // MOCK_THREAD_SAFE
 
 namespace {
@@ -689,6 +733,15 @@ BOOST_FIXTURE_TEST_CASE(std_unique_ptr_argument_is_supported_in_action, mock_err
     CHECK_CALLS(1);
 }
 
+BOOST_FIXTURE_TEST_CASE(move_only_functor_is_supported_in_action, mock_error_fixture)
+{
+    MOCK_FUNCTOR(f, int());
+    std::unique_ptr<int> p(new int(7));
+    MOCK_EXPECT(f).once().calls([p = std::move(p)]() { return *p; });
+    BOOST_TEST(f() == 7);
+    CHECK_CALLS(1);
+}
+
 BOOST_FIXTURE_TEST_CASE(std_unique_ptr_argument_is_supported_in_equal_constraint, mock_error_fixture)
 {
     {
@@ -762,3 +815,48 @@ BOOST_FIXTURE_TEST_CASE(unique_ptr_works_in_class, mock_error_fixture)
     BOOST_TEST(mock::verify());
     CHECK_CALLS(3);
 }
+
+namespace {
+MOCK_CLASS(mock_bucketing)
+{
+    MOCK_METHOD(bucket, 1, int(double))
+};
+
+/// Counts the readings of a sensor falling into each bucket
+template<typename Bucketing>
+std::map<int, int> histogram(Bucketing& bucketing, const std::vector<double>& readings)
+{
+    std::map<int, int> result;
+    for(double reading : readings)
+        ++result[bucketing.bucket(reading)];
+    return result;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(sensor_readings_are_bucketed_by_indexed_range_expectations, mock_error_fixture)
+{
+    const int buckets = 5000;
+    mock_bucketing m;
+    MOCK_INDEX(m.bucket);
+    MOCK_EXPECT(m.bucket).with(mock::near(1000., 0.01)).returns(-2);
+    for(int i = 0; i < buckets; ++i)
+        MOCK_EXPECT(m.bucket).with(mock::greater_equal(i * 0.5) && mock::less((i + 1) * 0.5)).returns(i);
+    MOCK_EXPECT(m.bucket).returns(-1);
+    std::vector<double> readings;
+    for(int i = 0; i < 1000; ++i)
+        readings.push_back(i * 2.5 + 0.25);
+    readings.push_back(1000.);
+    readings.push_back(0.);
+    readings.push_back(0.5);
+    readings.push_back(-0.5);
+    readings.push_back(buckets * 0.5);
+    readings.push_back(std::numeric_limits<double>::quiet_NaN());
+    const std::map<int, int> result = histogram(m, readings);
+    BOOST_TEST(result.size() == 1003u);
+    for(int i = 0; i < 1000; ++i)
+        BOOST_TEST(result.at(i * 5) == (i ? 1 : 2));
+    BOOST_TEST(result.at(1) == 1);
+    BOOST_TEST(result.at(-2) == 1);
+    BOOST_TEST(result.at(-1) == 3);
+    CHECK_CALLS(1006);
+}
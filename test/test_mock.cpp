@@ -168,6 +168,28 @@ BOOST_FIXTURE_TEST_CASE(MOCK_RESET_macro, mock_error_fixture)
     MOCK_RESET(m.my_method);
 }
 
+BOOST_FIXTURE_TEST_CASE(MOCK_INDEX_macro, mock_error_fixture)
+{
+    my_mock m;
+    MOCK_INDEX(m.my_method);
+    MOCK_EXPECT(m.my_method).once().with(42);
+    MOCK_EXPECT(m.my_method).once().with(43);
+    m.my_method(43);
+    m.my_method(42);
+    CHECK_CALLS(2);
+}
+
+BOOST_FIXTURE_TEST_CASE(MOCK_FREEZE_macro, mock_error_fixture)
+{
+    my_mock m;
+    MOCK_EXPECT(m.my_method).once().with(42);
+    MOCK_EXPECT(m.my_method).once().with(43);
+    MOCK_FREEZE(m.my_method);
+    m.my_method(43);
+    m.my_method(42);
+    CHECK_CALLS(2);
+}
+
 BOOST_FIXTURE_TEST_CASE(MOCK_EXPECT_macro, mock_error_fixture)
 {
     my_mock m;
@@ -197,6 +219,19 @@ BOOST_FIXTURE_TEST_CASE(mock_object_is_named, mock_error_fixture)
     BOOST_CHECK_EQUAL("m.my_mock::my_method", to_string(MOCK_HELPER(m.my_method)));
 }
 
+BOOST_FIXTURE_TEST_CASE(mock_method_is_registered_once_upon_first_call, mock_error_fixture)
+{
+    my_mock m;
+    BOOST_TEST(!m.my_method_mock_.registered());
+    CHECK_ERROR(m.my_method(1), "unexpected call", 0, "?.my_mock::my_method( 1 )");
+    BOOST_TEST(m.my_method_mock_.registered());
+    MOCK_EXPECT(m.my_method).once().with(2);
+    CHECK_ERROR(BOOST_CHECK(!mock::verify(m)), "verification failed", 0, "m.my_mock::my_method\n. once().with( 2 )");
+    m.my_method(2);
+    CHECK_CALLS(1);
+    CHECK_ERROR(m.my_method(3), "unexpected call", 0, "m.my_mock::my_method( 3 )\nv once().with( 2 )");
+}
+
 BOOST_FIXTURE_TEST_CASE(mock_object_shared_pointer_is_named, mock_error_fixture)
 {
     std::shared_ptr<my_mock> m(new my_mock);
@@ -309,6 +344,15 @@ BOOST_FIXTURE_TEST_CASE(mock_static_function_is_named, mock_error_fixture)
     BOOST_CHECK_EQUAL("static_function_class::f", to_string(MOCK_HELPER(static_function_class::f)));
 }
 
+BOOST_FIXTURE_TEST_CASE(mock_static_function_is_registered_once_and_keeps_its_name_when_called, mock_error_fixture)
+{
+    MOCK_EXPECT(static_function_class::f).once().with(1).returns(2.f);
+    BOOST_TEST(static_function_class::f(1) == 2.f);
+    CHECK_CALLS(1);
+    CHECK_ERROR(static_function_class::f(3), "unexpected call", 0, "static_function_class::f( 3 )\nv once().with( 1 )");
+    MOCK_RESET(static_function_class::f);
+}
+
 namespace {
 MOCK_CLASS(round_parenthesized_signature)
 {
@@ -395,3 +439,42 @@ MOCK_BASE_CLASS(derived, base)
 
 MOCK_FUNCTION(MOCK_STDCALL f, 0, void(), f)
 } // namespace stdcall
+
+namespace {
+struct counted
+{
+    counted() = default;
+    counted(const counted&) { ++copies; }
+    counted(counted&&) noexcept { ++moves; }
+
+    static int copies;
+    static int moves;
+};
+int counted::copies = 0;
+int counted::moves = 0;
+
+MOCK_CLASS(mock_class_taking_arguments_by_value)
+{
+    MOCK_METHOD(method, 1, void(counted))
+    MOCK_STATIC_METHOD(static_method, 1, void(counted), static_method)
+};
+MOCK_FUNCTION(function_taking_arguments_by_value, 1, void(counted))
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(arguments_taken_by_value_are_copied_once_by_the_mocked_function_only, mock_error_fixture)
+{
+    mock_class_taking_arguments_by_value m;
+    const auto functor = [](const counted&) {};
+    MOCK_EXPECT(m.method).once().with(mock::any).calls(functor);
+    MOCK_EXPECT(m.static_method).once().with(mock::any).calls(functor);
+    MOCK_EXPECT(function_taking_arguments_by_value).once().with(mock::any).calls(functor);
+    const counted c;
+    counted::copies = counted::moves = 0;
+    m.method(c);
+    mock_class_taking_arguments_by_value::static_method(c);
+    function_taking_arguments_by_value(c);
+    BOOST_TEST(counted::copies == 3);
+    BOOST_TEST(counted::moves == 0);
+    CHECK_CALLS(3);
+    mock::reset();
+}
@@ -0,0 +1,69 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#define MOCK_MUTEX_POLICY mock::spin_mutex
+#include "mock_error.hpp"
+#include <turtle/mock.hpp>
+#include <boost/test/unit_test.hpp>
+#include <type_traits>
+
+BOOST_AUTO_TEST_CASE(mutex_policy_replaces_the_mutex_of_the_library)
+{
+    BOOST_TEST((std::is_same<mock::detail::mutex, mock::spin_mutex>::value));
+}
+
+BOOST_AUTO_TEST_CASE(spin_mutex_is_reentrant)
+{
+    mock::spin_mutex m;
+    m.lock();
+    m.lock();
+    m.unlock();
+    m.unlock();
+    m.lock();
+    m.unlock();
+}
+
+#ifdef MOCK_THREAD_SAFE
+
+#    include <boost/thread.hpp>
+
+BOOST_AUTO_TEST_CASE(spin_mutex_excludes_other_threads)
+{
+    mock::spin_mutex m;
+    int counter = 0;
+    boost::thread_group group;
+    for(int i = 0; i < 4; ++i)
+        group.create_thread([&m, &counter]() {
+            for(int j = 0; j < 10000; ++j)
+            {
+                m.lock();
+                ++counter;
+                m.unlock();
+            }
+        });
+    group.join_all();
+    BOOST_TEST(counter == 40000);
+}
+
+#endif // MOCK_THREAD_SAFE
+
+namespace {
+MOCK_CLASS(mock_class)
+{
+    MOCK_METHOD(method, 1, int(int))
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(mock_objects_work_with_a_custom_mutex_policy, mock_error_fixture)
+{
+    mock_class m;
+    MOCK_EXPECT(m.method).once().with(1).returns(2);
+    BOOST_TEST(m.method(1) == 2);
+    BOOST_TEST(mock::verify(m));
+    CHECK_CALLS(1);
+}
@@ -8,6 +8,7 @@
 
 #include "mock_error.hpp"
 #include <turtle/detail/function.hpp>
+#include <turtle/freeze.hpp>
 #include <turtle/reset.hpp>
 #include <turtle/verify.hpp>
 #include <boost/test/unit_test.hpp>
@@ -58,6 +59,21 @@ BOOST_FIXTURE_TEST_CASE(resetting_an_object_containing_a_failing_expectation_and
     BOOST_CHECK(mock::verify(o));
 }
 
+BOOST_FIXTURE_TEST_CASE(freezing_an_object_freezes_its_expectations, fixture)
+{
+    e.expect().once();
+    e.expect().once();
+    mock::freeze(o);
+    e();
+    e();
+    CHECK_CALLS(2);
+    CHECK_ERROR(e(), "unexpected call", 0, "instanceobject::name()\nv once()\nv once()");
+    e.expect().once();
+    mock::freeze();
+    e();
+    CHECK_CALLS(1);
+}
+
 BOOST_FIXTURE_TEST_CASE(an_object_is_assignable_by_sharing_its_state, mock_error_fixture)
 {
     object o1;
@@ -0,0 +1,85 @@
+// http://turtle.sourceforge.net
+//
+// Copyright Alexander Grund 2022
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "mock_error.hpp"
+#include <turtle/constraints.hpp>
+#include <turtle/static_expectations.hpp>
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace {
+template<typename F>
+int sum(F& f, int count)
+{
+    int result = 0;
+    for(int i = 0; i < count; ++i)
+        result += f(i % 3);
+    return result;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(static_expectations_are_selected_in_declaration_order, mock_error_fixture)
+{
+    auto f = mock::static_expectations<int(int)>(mock::static_expect(0).returns(10),
+                                                 mock::static_expect(mock::less(2)).returns(20),
+                                                 mock::static_expect().returns(30));
+    BOOST_TEST(sum(f, 3) == 60);
+    CHECK_CALLS(3);
+}
+
+BOOST_FIXTURE_TEST_CASE(exhausted_static_expectations_are_skipped, mock_error_fixture)
+{
+    auto f = mock::static_expectations<std::string(const std::string&, int)>(
+      mock::static_expect("first", mock::any).once().returns("once"),
+      mock::static_expect(mock::any, mock::any).at_most(1).returns(std::string("at most once")));
+    BOOST_TEST(f("first", 1) == "once");
+    BOOST_TEST(f("first", 1) == "at most once");
+    CHECK_CALLS(2);
+    CHECK_ERROR(f("second", 2),
+                "unexpected call",
+                0,
+                "?( \"second\", 2 )\nv once().with( \"first\", any )\nv at_most( 1/1 ).with( any, any )");
+}
+
+BOOST_FIXTURE_TEST_CASE(static_expectations_call_functors_and_throw_exceptions, mock_error_fixture)
+{
+    int calls = 0;
+    auto f = mock::static_expectations<void(int)>(mock::static_expect(1).calls([&calls](int i) { calls += i; }),
+                                                  mock::static_expect(2).throws(std::runtime_error("error")),
+                                                  mock::static_expect(3));
+    f(1);
+    f(3);
+    BOOST_CHECK_THROW(f(2), std::runtime_error);
+    BOOST_TEST(calls == 1);
+    CHECK_CALLS(3);
+}
+
+BOOST_FIXTURE_TEST_CASE(static_expectation_without_action_for_a_non_void_function_is_reported, mock_error_fixture)
+{
+    auto f = mock::static_expectations<int()>(mock::static_expect().once());
+    CHECK_ERROR(f(), "missing action", 0, "?()\nv once()");
+}
+
+BOOST_FIXTURE_TEST_CASE(verifying_static_expectations_reports_untriggered_ones, mock_error_fixture)
+{
+    auto f = mock::static_expectations<void(int)>(mock::static_expect(1).once(), mock::static_expect(2).never());
+    CHECK_ERROR(BOOST_CHECK(!f.verify()), "verification failed", 0, "?\n. once().with( 1 )\nv never().with( 2 )");
+    f(1);
+    CHECK_CALLS(1);
+    BOOST_TEST(f.verify());
+}
+
+BOOST_FIXTURE_TEST_CASE(static_expectations_report_untriggered_expectations_upon_destruction, mock_error_fixture)
+{
+    CHECK_ERROR(
+      { auto f = mock::static_expectations<void()>(mock::static_expect().once()); },
+      "untriggered expectation",
+      0,
+      "?\n. once()");
+}